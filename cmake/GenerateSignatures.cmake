@@ -0,0 +1,129 @@
+# Turns the signatures in config.json into constexpr patterns for
+# StaticPatternMatcher. Run in script mode:
+#
+#   cmake -DINPUT=config.json -DOUTPUT=builtinsignatures_generated.h -P GenerateSignatures.cmake
+#
+# Every distinct pattern becomes one struct with a BYTES array, -1 marking a
+# wildcard, and the NAME of the first configuration using it.
+# BuiltinSignatureList names them all. The header is only
+# included from builtinsignatures.cpp, after staticpatternmatcher.h
+
+cmake_minimum_required(VERSION 3.19)
+
+if(NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "GenerateSignatures.cmake needs -DINPUT=<config.json> -DOUTPUT=<header>")
+endif()
+
+file(READ "${INPUT}" json)
+
+# config.json is saved with a UTF-8 byte order mark
+string(SUBSTRING "${json}" 0 1 first)
+if(NOT first STREQUAL "{")
+    string(FIND "${json}" "{" start)
+    string(SUBSTRING "${json}" ${start} -1 json)
+endif()
+
+string(JSON count ERROR_VARIABLE error LENGTH "${json}" configurations)
+if(error)
+    message(FATAL_ERROR "${INPUT}: ${error}")
+endif()
+
+set(patterns "")
+set(structs "")
+set(names "")
+set(index 0)
+
+if(count GREATER 0)
+    math(EXPR last "${count} - 1")
+    foreach(i RANGE ${last})
+        string(JSON displayName GET "${json}" configurations ${i} display_name)
+        # Also lands in a // comment, where a trailing backslash would splice
+        # the next line into it
+        string(REGEX REPLACE "[\r\n]" " " displayName "${displayName}")
+        string(JSON kind TYPE "${json}" configurations ${i} autoplay)
+
+        set(bytes "")
+        if(kind STREQUAL "ARRAY")
+            string(JSON length LENGTH "${json}" configurations ${i} autoplay)
+            if(length GREATER 0)
+                math(EXPR lastByte "${length} - 1")
+                foreach(b RANGE ${lastByte})
+                    string(JSON value GET "${json}" configurations ${i} autoplay ${b})
+                    list(APPEND bytes "${value}")
+                endforeach()
+            endif()
+        elseif(kind STREQUAL "STRING")
+            string(JSON text GET "${json}" configurations ${i} autoplay)
+            string(REGEX MATCHALL "[^ \t]+" tokens "${text}")
+            foreach(token IN LISTS tokens)
+                if(token STREQUAL "?" OR token STREQUAL "??")
+                    list(APPEND bytes -1)
+                elseif(token MATCHES "^[0-9A-Fa-f][0-9A-Fa-f]$")
+                    math(EXPR value "0x${token}")
+                    list(APPEND bytes "${value}")
+                else()
+                    message(FATAL_ERROR "${INPUT}: '${displayName}' has invalid pattern token '${token}'")
+                endif()
+            endforeach()
+        endif()
+
+        # Malformed entries are left to ConfigManager to reject at runtime
+        set(valid TRUE)
+        if(NOT bytes)
+            set(valid FALSE)
+        endif()
+        foreach(value IN LISTS bytes)
+            if(NOT value MATCHES "^-?[0-9]+$" OR value LESS -1 OR value GREATER 255)
+                set(valid FALSE)
+            endif()
+        endforeach()
+        if(NOT valid)
+            continue()
+        endif()
+
+        string(JOIN ", " joined ${bytes})
+        list(FIND patterns "${joined}" known)
+        if(known GREATER -1)
+            string(REPLACE "\\" "/" otherName "${displayName}")
+            string(APPEND comment_${known} ", ${otherName}")
+            continue()
+        endif()
+
+        list(APPEND patterns "${joined}")
+        list(LENGTH bytes size)
+        string(REPLACE "\\" "/" comment_${index} "${displayName}")
+        string(REPLACE "\\" "\\\\" escapedName "${displayName}")
+        string(REPLACE "\"" "\\\"" escapedName "${escapedName}")
+        set(body_${index} "    static constexpr const char* NAME = \"${escapedName}\";\n")
+        string(APPEND body_${index} "    static constexpr std::array<int16_t, ${size}> BYTES = {${joined}};\n")
+        list(APPEND names "Signature${index}")
+        math(EXPR index "${index} + 1")
+    endforeach()
+endif()
+
+if(index GREATER 0)
+    math(EXPR lastPattern "${index} - 1")
+    foreach(p RANGE ${lastPattern})
+        string(APPEND structs "// ${comment_${p}}\nstruct Signature${p} {\n${body_${p}}};\n\n")
+    endforeach()
+endif()
+string(JOIN ", " list ${names})
+
+file(WRITE "${OUTPUT}"
+"// Generated from config.json by cmake/GenerateSignatures.cmake; do not edit
+
+#ifndef BUILTINSIGNATURES_GENERATED_H
+#define BUILTINSIGNATURES_GENERATED_H
+
+// STL includes
+#include <array>
+#include <cstdint>
+
+namespace BuiltinSignaturePatterns {
+
+${structs}using BuiltinSignatureList = SignatureList<${list}>;
+
+} // namespace BuiltinSignaturePatterns
+
+#endif // BUILTINSIGNATURES_GENERATED_H
+")
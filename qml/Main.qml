@@ -69,6 +69,22 @@ ApplicationWindow {
         ConnectionStatus {
             width: parent.width
         }
+
+        HoverHandler {
+            id: statusHover
+        }
+
+        ToolTip.visible: statusHover.hovered && scanner && scanner.inAutoplay
+        ToolTip.delay: 500
+        ToolTip.text: {
+            if (!scanner) {
+                return ""
+            }
+            var latency = scanner.autoplayLatency
+            return "Read p99: " + latency.read.p99_us.toFixed(0) + " µs\n" +
+                   "Level start to flag p99: " + (latency.reaction_bound.p99_us / 1000).toFixed(1) + " ms\n" +
+                   "Missed levels: " + latency.missed_transitions
+        }
     }
 
     component ConnectionStatus: Text {
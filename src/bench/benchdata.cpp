@@ -0,0 +1,232 @@
+#include "benchdata.h"
+
+// STL includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+// Project includes
+#include "../core/builtinsignatures.h"
+#include "../platform/snapshot/snapshotwriter.h"
+
+namespace {
+
+constexpr size_t DEFAULT_IMAGE_MB = 256;
+constexpr uint64_t IMAGE_SEED = 0x42424131;
+constexpr uint64_t SNAPSHOT_SEED = 0x534e4150;
+constexpr uintptr_t SYNTHETIC_BASE = 0x10000000000ULL;
+
+// Region sizes cycled through by SyntheticProcessMemory, roughly the mix a
+// game heap commits
+constexpr size_t REGION_SIZES[] = {
+    64 * 1024, 16 * 1024 * 1024, 256 * 1024, 1024 * 1024, 64 * 1024 * 1024, 4 * 1024 * 1024
+};
+
+} // namespace
+
+namespace BenchData {
+
+const char* distributionName(Distribution distribution)
+{
+    switch (distribution) {
+        case Distribution::Zeros:
+            return "zeros";
+        case Distribution::Random:
+            return "random";
+        case Distribution::Heap:
+            break;
+    }
+    return "heap";
+}
+
+size_t imageSize()
+{
+    static const size_t size = []() {
+        size_t megabytes = DEFAULT_IMAGE_MB;
+        if (const char* value = std::getenv("BBA_BENCH_IMAGE_MB")) {
+            megabytes = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        }
+        return megabytes * 1024 * 1024;
+    }();
+    return size;
+}
+
+const std::vector<uint8_t>& image(Distribution distribution)
+{
+    static std::vector<uint8_t> data;
+    static Distribution current = Distribution::Zeros;
+    static bool generated = false;
+
+    if (generated && current == distribution) {
+        return data;
+    }
+
+    data.assign(imageSize(), 0);
+    if (distribution == Distribution::Random) {
+        std::mt19937_64 rng(IMAGE_SEED);
+        for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+            const uint64_t word = rng();
+            std::memcpy(data.data() + i, &word, sizeof(word));
+        }
+    } else if (distribution == Distribution::Heap) {
+        fillHeap(data.data(), data.size(), IMAGE_SEED);
+    }
+
+    current = distribution;
+    generated = true;
+    return data;
+}
+
+void fillHeap(uint8_t* data, size_t size, uint64_t seed)
+{
+    static const uint64_t ARENAS[] = {0x000001A000000000ULL, 0x000002B400000000ULL, 0x00007FF600000000ULL};
+    static const char TEXT[] = "NoteHitTrackSongLevelScoreComboPlayerAudioClipMenuBeat";
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> real(0.0, 1000.0);
+
+    size_t pos = 0;
+    while (pos + 8 <= size) {
+        const uint64_t roll = rng() % 100;
+        uint64_t word = 0;
+
+        if (roll < 35) {
+            // Zero fill: padding, cleared arrays, null pointers
+            const size_t words = std::min<size_t>(1 + rng() % 16, (size - pos) / 8);
+            std::memset(data + pos, 0, words * 8);
+            pos += words * 8;
+            continue;
+        } else if (roll < 55) {
+            word = rng() % 256;
+        } else if (roll < 75) {
+            word = ARENAS[rng() % 3] + ((rng() % 0x40000000ULL) & ~uint64_t(7));
+        } else if (roll < 85) {
+            const double value = real(rng);
+            std::memcpy(&word, &value, sizeof(word));
+        } else if (roll < 95) {
+            std::memcpy(&word, TEXT + rng() % (sizeof(TEXT) - 9), sizeof(word));
+        } else {
+            word = rng();
+        }
+
+        std::memcpy(data + pos, &word, sizeof(word));
+        pos += 8;
+    }
+}
+
+const std::string& snapshotPath()
+{
+    static const std::string path = []() {
+        std::error_code error;
+        std::filesystem::path file = std::filesystem::temp_directory_path(error) / "bba_bench.bbasnap";
+        if (error) {
+            return std::string();
+        }
+
+        SyntheticProcessMemory process(imageSize(), SNAPSHOT_SEED);
+        SnapshotWriter writer(process);
+        if (!writer.write(file.string())) {
+            return std::string();
+        }
+        return file.string();
+    }();
+    return path;
+}
+
+} // namespace BenchData
+
+SyntheticProcessMemory::SyntheticProcessMemory(size_t totalSize, uint64_t seed)
+{
+    uintptr_t base = SYNTHETIC_BASE;
+    size_t remaining = totalSize;
+    size_t next = 0;
+
+    while (remaining > 0) {
+        const size_t size = std::min(REGION_SIZES[next++ % (sizeof(REGION_SIZES) / sizeof(REGION_SIZES[0]))], remaining);
+
+        Region region;
+        region.info = {base, size, MemoryProtection::READ | MemoryProtection::WRITE, RegionType::Private};
+        region.bytes.resize(size);
+        BenchData::fillHeap(region.bytes.data(), size, seed + m_regions.size());
+        m_regions.push_back(std::move(region));
+
+        // Leave unmapped space between regions, as a real address space has
+        base += size + 64 * 1024;
+        remaining -= size;
+    }
+
+    // The newest known signature sits at the end of the highest region, so
+    // a scan for it reads everything before finding it
+    if (BuiltinSignatures::count() > 0 && !m_regions.empty()) {
+        const BytePattern& pattern = BuiltinSignatures::pattern(BuiltinSignatures::count() - 1);
+        std::vector<uint8_t>& bytes = m_regions.back().bytes;
+        if (bytes.size() >= pattern.size()) {
+            uint8_t* target = bytes.data() + bytes.size() - pattern.size();
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                if (pattern.isFixed(i)) {
+                    target[i] = pattern.values()[i];
+                }
+            }
+        }
+    }
+}
+
+std::vector<MemoryRegion> SyntheticProcessMemory::enumerateRegions() const
+{
+    std::vector<MemoryRegion> regions;
+    regions.reserve(m_regions.size());
+    for (const Region& region : m_regions) {
+        regions.push_back(region.info);
+    }
+    return regions;
+}
+
+size_t SyntheticProcessMemory::read(uintptr_t address, void* buffer, size_t size) const
+{
+    countSyscalls();
+
+    const Region* region = findRegion(address);
+    if (!region) {
+        return 0;
+    }
+
+    const size_t offset = address - region->info.base;
+    const size_t available = std::min(size, region->info.size - offset);
+    std::memcpy(buffer, region->bytes.data() + offset, available);
+    return available;
+}
+
+const uint8_t* SyntheticProcessMemory::view(uintptr_t address, size_t size) const
+{
+    if (!m_viewEnabled) {
+        return nullptr;
+    }
+
+    const Region* region = findRegion(address);
+    if (!region || address - region->info.base + size > region->info.size) {
+        return nullptr;
+    }
+    return region->bytes.data() + (address - region->info.base);
+}
+
+bool SyntheticProcessMemory::write(uintptr_t address, const void* buffer, size_t size) const
+{
+    (void)address;
+    (void)buffer;
+    (void)size;
+    return false;
+}
+
+const SyntheticProcessMemory::Region* SyntheticProcessMemory::findRegion(uintptr_t address) const
+{
+    auto it = std::upper_bound(m_regions.begin(), m_regions.end(), address, [](uintptr_t value, const Region& region) {
+        return value < region.info.base;
+    });
+    if (it == m_regions.begin()) {
+        return nullptr;
+    }
+    --it;
+    return (address - it->info.base < it->info.size) ? &*it : nullptr;
+}
@@ -0,0 +1,66 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "../platform/processmemory.h"
+
+// Synthetic inputs shared by the benchmarks. Everything is generated from
+// fixed seeds, so two runs on the same build search identical bytes
+namespace BenchData {
+    enum class Distribution { Zeros, Random, Heap };
+
+    const char* distributionName(Distribution distribution);
+
+    // Bytes per generated image; BBA_BENCH_IMAGE_MB overrides the default
+    size_t imageSize();
+
+    // Generated on first use and kept until another distribution is asked
+    // for, so only one image is resident at a time
+    const std::vector<uint8_t>& image(Distribution distribution);
+
+    // Fills data like a 64-bit game heap: runs of zero words, small
+    // integers, pointers into a few arenas, doubles and short strings
+    void fillHeap(uint8_t* data, size_t size, uint64_t seed);
+
+    // Snapshot of a SyntheticProcessMemory with imageSize() bytes of heap,
+    // written once per run into the temp directory. Empty on failure
+    const std::string& snapshotPath();
+}
+
+// In-memory process with heap-like regions spread over the address space.
+// Reads are plain copies; view() can be turned off to force the copying
+// scan paths
+class SyntheticProcessMemory : public IProcessMemory
+{
+public:
+    SyntheticProcessMemory(size_t totalSize, uint64_t seed);
+
+    void setViewEnabled(bool enabled) { m_viewEnabled = enabled; }
+
+    uint32_t processId() const override { return 1; }
+    bool isAlive() const override { return true; }
+    std::string modulePath() const override { return "synthetic.exe"; }
+    std::vector<MemoryRegion> enumerateRegions() const override;
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    const uint8_t* view(uintptr_t address, size_t size) const override;
+    bool write(uintptr_t address, const void* buffer, size_t size) const override;
+
+private:
+    struct Region {
+        MemoryRegion info;
+        std::vector<uint8_t> bytes;
+    };
+
+    const Region* findRegion(uintptr_t address) const;
+
+    std::vector<Region> m_regions;
+    bool m_viewEnabled = true;
+};
+
+#endif // BENCHDATA_H
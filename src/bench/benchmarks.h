@@ -0,0 +1,16 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// Each group registers its benchmarks with Google Benchmark at startup.
+// Names read group/subject/variant so --benchmark_filter can pick a slice
+namespace Benchmarks {
+    // search/, multisearch/, compare/ and build/: the matchers on their own
+    void registerSearch();
+    // scan/: RegionScanner end to end over a synthetic process, the
+    // region diff a rescan starts with and how fast a scan stops
+    void registerScan();
+    // config/: loading config.json and the compiled config
+    void registerConfig();
+}
+
+#endif // BENCHMARKS_H
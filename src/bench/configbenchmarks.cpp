@@ -0,0 +1,91 @@
+#include "benchmarks.h"
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+// Benchmark includes
+#include <benchmark/benchmark.h>
+
+// Project includes
+#include "../utils/configmanager.h"
+
+namespace {
+
+// A private copy of the source tree's config.json, so compiling it never
+// writes next to the original
+class ConfigFixture
+{
+public:
+    ConfigFixture()
+    {
+        m_path = m_dir.filePath(Constants::CONFIG_FILENAME);
+        m_ready = m_dir.isValid() && QFile::copy(BBA_BENCH_CONFIG_PATH, m_path);
+    }
+
+    bool isReady() const { return m_ready; }
+    QString path() const { return m_path; }
+    QString compiledPath() const { return ConfigManager::compiledPathFor(m_path); }
+
+private:
+    QTemporaryDir m_dir;
+    QString m_path;
+    bool m_ready;
+};
+
+// A first start: parse the JSON, build every matcher and write the
+// compiled config
+void loadJsonBenchmark(benchmark::State& state)
+{
+    ConfigFixture fixture;
+    if (!fixture.isReady()) {
+        state.SkipWithError("Could not copy config.json");
+        return;
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        QFile::remove(fixture.compiledPath());
+        state.ResumeTiming();
+
+        ConfigManager config;
+        if (!config.loadFromFile(fixture.path())) {
+            state.SkipWithError("config.json failed to load");
+            return;
+        }
+        benchmark::DoNotOptimize(config.getConfigurations().size());
+    }
+}
+
+// Every later start: map the compiled config and read it in place
+void loadCompiledBenchmark(benchmark::State& state)
+{
+    ConfigFixture fixture;
+    ConfigManager warmup;
+    if (!fixture.isReady() || !warmup.loadFromFile(fixture.path()) || !QFile::exists(fixture.compiledPath())) {
+        state.SkipWithError("Could not compile config.json");
+        return;
+    }
+
+    for (auto _ : state) {
+        ConfigManager config;
+        if (!config.loadFromFile(fixture.path())) {
+            state.SkipWithError("Compiled config failed to load");
+            return;
+        }
+        benchmark::DoNotOptimize(config.getConfigurations().size());
+    }
+}
+
+} // namespace
+
+namespace Benchmarks {
+
+void registerConfig()
+{
+    benchmark::RegisterBenchmark("config/load/json", loadJsonBenchmark)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("config/load/compiled", loadCompiledBenchmark)->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,41 @@
+// Scan engine microbenchmarks. Results go to the console and, for tracking
+// across releases, to JSON:
+//
+//   bba_bench --benchmark_out=bba_bench.json --benchmark_out_format=json
+//   bba_bench --benchmark_filter='search/v49/heap'
+//
+// BBA_BENCH_IMAGE_MB sets the size of the synthetic images (default 256)
+
+// STL includes
+#include <string>
+
+// Benchmark includes
+#include <benchmark/benchmark.h>
+
+// Project includes
+#include "benchdata.h"
+#include "benchmarks.h"
+#include "../core/builtinsignatures.h"
+#include "../core/patternmatcher.h"
+#include "../utils/constants.h"
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("app_version", Constants::APP_VERSION);
+    benchmark::AddCustomContext("search_kernel", PatternMatcher::kernelName(PatternMatcher::activeKernel()));
+    benchmark::AddCustomContext("builtin_signatures", std::to_string(BuiltinSignatures::count()));
+    benchmark::AddCustomContext("image_mb", std::to_string(BenchData::imageSize() / (1024 * 1024)));
+
+    Benchmarks::registerSearch();
+    Benchmarks::registerScan();
+    Benchmarks::registerConfig();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
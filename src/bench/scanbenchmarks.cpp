@@ -0,0 +1,205 @@
+#include "benchmarks.h"
+
+// STL includes
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Benchmark includes
+#include <benchmark/benchmark.h>
+
+// Project includes
+#include "benchdata.h"
+#include "../core/builtinsignatures.h"
+#include "../core/cancellationtoken.h"
+#include "../core/multipatternmatcher.h"
+#include "../core/regionscanner.h"
+#include "../core/regiontracker.h"
+#include "../core/scanthreadpool.h"
+#include "../platform/snapshot/snapshotprocessmemory.h"
+
+namespace {
+
+constexpr uint64_t COPY_PROCESS_SEED = 0x434f5059;
+// How far into a scan scan/stop cancels it
+constexpr int STOP_DELAY_MS = 2;
+
+// Every built-in signature, as when the build's MD5 is unknown, or only
+// the newest one, as when it is known
+MultiPatternMatcher signatureMatcher(bool all)
+{
+    std::vector<PatternMatcher> matchers;
+    const size_t first = all ? 0 : BuiltinSignatures::count() - 1;
+    for (size_t i = first; i < BuiltinSignatures::count(); ++i) {
+        matchers.emplace_back(BuiltinSignatures::pattern(i));
+        matchers.back().setCompare(BuiltinSignatures::compare(i));
+    }
+    return MultiPatternMatcher(matchers);
+}
+
+void runScan(benchmark::State& state, const IProcessMemory& process, const RegionScanOptions& options, bool allSignatures)
+{
+    const std::vector<MemoryRegion> regions = process.enumerateRegions();
+    const MultiPatternMatcher matcher = signatureMatcher(allSignatures);
+    // Kept across iterations, as MemoryScanner keeps them across retries
+    ScanBufferPool pool;
+    ScanThreadPool threads;
+    RegionScanner scanner(process, options, &pool, &threads);
+
+    uint64_t bytes = 0;
+    uint64_t syscalls = 0;
+    uint64_t stalls = 0;
+    uint64_t bytesBeforeHit = 0;
+    uint64_t pageFaults = 0;
+    uint64_t threadsStarted = 0;
+    for (auto _ : state) {
+        RegionMatch result;
+        if (!scanner.scan(regions, matcher, CancellationToken(), result)) {
+            state.SkipWithError("Planted signature was not found");
+            return;
+        }
+        bytes += scanner.getStats().bytesScanned;
+        syscalls += scanner.getStats().syscalls;
+        stalls += scanner.getStats().stalls;
+        bytesBeforeHit += scanner.getStats().bytesBeforeHit;
+        pageFaults += scanner.getStats().pageFaults;
+        threadsStarted += scanner.getStats().threadsStarted;
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["workers"] = static_cast<double>(scanner.getStats().workers.size());
+    state.counters["syscalls"] = benchmark::Counter(static_cast<double>(syscalls), benchmark::Counter::kAvgIterations);
+    state.counters["stalls"] = benchmark::Counter(static_cast<double>(stalls), benchmark::Counter::kAvgIterations);
+    state.counters["page_faults"] = benchmark::Counter(static_cast<double>(pageFaults),
+                                                       benchmark::Counter::kAvgIterations);
+    state.counters["peak_rss_mb"] = static_cast<double>(scanner.getStats().peakRss) / (1024.0 * 1024.0);
+    state.counters["threads_started"] = benchmark::Counter(static_cast<double>(threadsStarted),
+                                                           benchmark::Counter::kAvgIterations);
+    state.counters["bytes_before_hit"] = benchmark::Counter(static_cast<double>(bytesBeforeHit),
+                                                            benchmark::Counter::kAvgIterations);
+}
+
+// Searches the recorded snapshot in place through view()
+void snapshotScanBenchmark(benchmark::State& state, bool allSignatures)
+{
+    const std::string& path = BenchData::snapshotPath();
+    std::string error;
+    std::unique_ptr<SnapshotProcessMemory> snapshot = path.empty() ? nullptr : SnapshotProcessMemory::open(path, error);
+    if (!snapshot) {
+        state.SkipWithError("Could not create the benchmark snapshot");
+        return;
+    }
+
+    RegionScanOptions options;
+    options.workerCount = static_cast<unsigned>(state.range(0));
+    runScan(state, *snapshot, options, allSignatures);
+}
+
+// Copies every chunk out of the process like a live scan does. Depth 1
+// reads a whole work item before searching it; deeper pipelines overlap
+// the copy of the next chunk with the search of the current one
+void copyScanBenchmark(benchmark::State& state)
+{
+    static SyntheticProcessMemory process(BenchData::imageSize(), COPY_PROCESS_SEED);
+    process.setViewEnabled(false);
+
+    RegionScanOptions options;
+    options.pipelineDepth = static_cast<size_t>(state.range(0));
+    options.workerCount = static_cast<unsigned>(state.range(1));
+    runScan(state, process, options, true);
+}
+
+// A watch pass over a process where nothing changed since the last miss:
+// the sampled hashes are all it reads, against scan/copy searching it all
+void rescanBenchmark(benchmark::State& state)
+{
+    static SyntheticProcessMemory process(BenchData::imageSize(), COPY_PROCESS_SEED);
+    process.setViewEnabled(false);
+
+    const std::vector<MemoryRegion> regions = process.enumerateRegions();
+    RegionTracker tracker;
+    tracker.update(process, regions);
+
+    const uint64_t syscallsBefore = process.getSyscallCount();
+    size_t candidates = 0;
+    for (auto _ : state) {
+        candidates = tracker.update(process, regions).size();
+        benchmark::DoNotOptimize(candidates);
+    }
+
+    state.counters["regions"] = static_cast<double>(regions.size());
+    state.counters["rescanned"] = static_cast<double>(candidates);
+    state.counters["syscalls"] = benchmark::Counter(static_cast<double>(process.getSyscallCount() - syscallsBefore),
+                                                    benchmark::Counter::kAvgIterations);
+}
+
+// Cancels a copying scan a few milliseconds in and times how long its
+// workers and readers take to notice and return, which is how long
+// stop() keeps the UI waiting
+void stopBenchmark(benchmark::State& state)
+{
+    static SyntheticProcessMemory process(BenchData::imageSize(), COPY_PROCESS_SEED);
+    process.setViewEnabled(false);
+
+    const std::vector<MemoryRegion> regions = process.enumerateRegions();
+    const MultiPatternMatcher matcher = signatureMatcher(true);
+    ScanBufferPool pool;
+    ScanThreadPool threads;
+
+    RegionScanOptions options;
+    options.pipelineDepth = static_cast<size_t>(state.range(0));
+    RegionScanner scanner(process, options, &pool, &threads);
+
+    uint64_t finished = 0;
+    for (auto _ : state) {
+        CancellationToken token;
+        RegionMatch result;
+        bool found = false;
+        std::future<void> scan = threads.submit([&]() {
+            found = scanner.scan(regions, matcher, token, result);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(STOP_DELAY_MS));
+        const auto stoppedAt = std::chrono::steady_clock::now();
+        token.cancel();
+        scan.wait();
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - stoppedAt).count());
+
+        finished += found ? 1 : 0;
+    }
+
+    // Scans that found the signature before the cancel; their time says
+    // nothing about stopping, so this should stay at 0
+    state.counters["finished"] = static_cast<double>(finished);
+    state.counters["threads"] = static_cast<double>(threads.getThreadCount());
+}
+
+} // namespace
+
+namespace Benchmarks {
+
+void registerScan()
+{
+    for (bool all : {false, true}) {
+        const std::string label = std::string("scan/snapshot/") + (all ? "unknown" : "known");
+        benchmark::RegisterBenchmark(label.c_str(), snapshotScanBenchmark, all)
+            ->ArgName("workers")->Arg(1)->Arg(0)
+            ->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+
+    benchmark::RegisterBenchmark("scan/copy", copyScanBenchmark)
+        ->ArgNames({"depth", "workers"})
+        ->ArgsProduct({{1, 2, 3}, {1, 0}})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+    benchmark::RegisterBenchmark("scan/rescan/unchanged", rescanBenchmark)->Unit(benchmark::kMicrosecond);
+
+    benchmark::RegisterBenchmark("scan/stop", stopBenchmark)
+        ->ArgName("depth")->Arg(1)->Arg(3)
+        ->Unit(benchmark::kMicrosecond)->UseManualTime();
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,203 @@
+#include "benchmarks.h"
+
+// STL includes
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+// Benchmark includes
+#include <benchmark/benchmark.h>
+
+// Project includes
+#include "benchdata.h"
+#include "../core/builtinsignatures.h"
+#include "../core/multipatternmatcher.h"
+#include "../core/patternmatcher.h"
+
+namespace {
+
+constexpr BenchData::Distribution DISTRIBUTIONS[] = {
+    BenchData::Distribution::Zeros, BenchData::Distribution::Random, BenchData::Distribution::Heap
+};
+
+constexpr size_t COMPARE_WINDOWS = 4096;
+
+enum class SearchMode { Generic, Static, Horspool };
+
+const char* modeName(SearchMode mode)
+{
+    switch (mode) {
+        case SearchMode::Generic:
+            return "generic";
+        case SearchMode::Static:
+            return "static";
+        case SearchMode::Horspool:
+            break;
+    }
+    return "horspool";
+}
+
+// Searches the whole buffer, restarting past every match, so each
+// iteration touches the same number of bytes whatever the data holds
+template <typename SearchFunction>
+uint64_t searchAll(const std::vector<uint8_t>& data, SearchFunction search)
+{
+    uint64_t matches = 0;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        const size_t offset = search(data.data() + pos, data.size() - pos);
+        if (offset == SIZE_MAX) {
+            break;
+        }
+        ++matches;
+        pos += offset + 1;
+    }
+    return matches;
+}
+
+void searchBenchmark(benchmark::State& state, size_t signature, BenchData::Distribution distribution, SearchMode mode)
+{
+    const std::vector<uint8_t>& data = BenchData::image(distribution);
+
+    PatternMatcher matcher(BuiltinSignatures::pattern(signature));
+    if (mode == SearchMode::Static) {
+        matcher.setCompare(BuiltinSignatures::compare(signature));
+    }
+
+    SearchStats stats;
+    uint64_t matches = 0;
+    for (auto _ : state) {
+        matches = searchAll(data, [&](const uint8_t* bytes, size_t size) {
+            return (mode == SearchMode::Horspool) ? matcher.searchScalar(bytes, size, &stats)
+                                                  : matcher.search(bytes, size, &stats);
+        });
+        benchmark::DoNotOptimize(matches);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    state.counters["matches"] = static_cast<double>(matches);
+    state.counters["compares"] = benchmark::Counter(static_cast<double>(stats.compares),
+                                                    benchmark::Counter::kAvgIterations);
+}
+
+void multiSearchBenchmark(benchmark::State& state, BenchData::Distribution distribution)
+{
+    const std::vector<uint8_t>& data = BenchData::image(distribution);
+
+    std::vector<PatternMatcher> matchers;
+    for (size_t i = 0; i < BuiltinSignatures::count(); ++i) {
+        matchers.emplace_back(BuiltinSignatures::pattern(i));
+        matchers.back().setCompare(BuiltinSignatures::compare(i));
+    }
+    MultiPatternMatcher matcher(matchers);
+
+    SearchStats stats;
+    uint64_t matches = 0;
+    for (auto _ : state) {
+        matches = searchAll(data, [&](const uint8_t* bytes, size_t size) {
+            return matcher.search(bytes, size, &stats).offset;
+        });
+        benchmark::DoNotOptimize(matches);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    state.counters["patterns"] = static_cast<double>(matchers.size());
+    state.counters["matches"] = static_cast<double>(matches);
+}
+
+// Candidate verification alone: windows that pass the anchor filter, half
+// of them failing on one fixed byte somewhere in the pattern
+void compareBenchmark(benchmark::State& state, size_t signature, bool specialized)
+{
+    const BytePattern& pattern = BuiltinSignatures::pattern(signature);
+    const size_t size = pattern.size();
+
+    std::mt19937_64 rng(signature + 1);
+    std::vector<uint8_t> windows(COMPARE_WINDOWS * size);
+    for (size_t w = 0; w < COMPARE_WINDOWS; ++w) {
+        uint8_t* window = windows.data() + w * size;
+        for (size_t i = 0; i < size; ++i) {
+            window[i] = pattern.isFixed(i) ? pattern.values()[i] : static_cast<uint8_t>(rng());
+        }
+        if (w % 2 == 1 && !pattern.fixedRuns().empty()) {
+            const BytePattern::Run& run = pattern.fixedRuns()[rng() % pattern.fixedRuns().size()];
+            window[run.offset + rng() % run.length] ^= 0x01;
+        }
+    }
+
+    PatternMatcher matcher(pattern);
+    if (specialized) {
+        matcher.setCompare(BuiltinSignatures::compare(signature));
+    }
+
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (size_t w = 0; w < COMPARE_WINDOWS; ++w) {
+            hits += matcher.matchesAt(windows.data() + w * size);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * COMPARE_WINDOWS));
+}
+
+// What a start costs per signature: deriving the bad-char table and
+// anchors from the pattern, against adopting them from the compiled config
+void buildBenchmark(benchmark::State& state, size_t signature, bool adopt)
+{
+    const BytePattern& pattern = BuiltinSignatures::pattern(signature);
+    const PatternMatcher derived(pattern);
+
+    std::array<uint32_t, 256> badCharTable;
+    for (size_t i = 0; i < badCharTable.size(); ++i) {
+        badCharTable[i] = static_cast<uint32_t>(derived.getBadCharTable()[i]);
+    }
+    const PatternMatcher::Tables tables = {
+        pattern.values(), pattern.mask(), pattern.size(),
+        derived.getAnchorIndex(), derived.getSecondAnchorIndex(), badCharTable.data()
+    };
+
+    for (auto _ : state) {
+        if (adopt) {
+            PatternMatcher matcher(tables);
+            benchmark::DoNotOptimize(matcher);
+        } else {
+            PatternMatcher matcher(pattern);
+            benchmark::DoNotOptimize(matcher);
+        }
+    }
+}
+
+} // namespace
+
+namespace Benchmarks {
+
+void registerSearch()
+{
+    // Distribution outermost, so each image is generated once
+    for (BenchData::Distribution distribution : DISTRIBUTIONS) {
+        const std::string suffix = std::string("/") + BenchData::distributionName(distribution);
+
+        for (size_t signature = 0; signature < BuiltinSignatures::count(); ++signature) {
+            for (SearchMode mode : {SearchMode::Generic, SearchMode::Static, SearchMode::Horspool}) {
+                const std::string label = "search/" + std::string(BuiltinSignatures::name(signature)) + suffix + "/" + modeName(mode);
+                benchmark::RegisterBenchmark(label.c_str(), searchBenchmark, signature, distribution, mode)
+                    ->Unit(benchmark::kMillisecond);
+            }
+        }
+
+        benchmark::RegisterBenchmark(("multisearch/all" + suffix).c_str(), multiSearchBenchmark, distribution)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    for (size_t signature = 0; signature < BuiltinSignatures::count(); ++signature) {
+        const std::string name = BuiltinSignatures::name(signature);
+        benchmark::RegisterBenchmark(("compare/" + name + "/generic").c_str(), compareBenchmark, signature, false);
+        benchmark::RegisterBenchmark(("compare/" + name + "/static").c_str(), compareBenchmark, signature, true);
+        benchmark::RegisterBenchmark(("build/" + name + "/derive").c_str(), buildBenchmark, signature, false);
+        benchmark::RegisterBenchmark(("build/" + name + "/adopt").c_str(), buildBenchmark, signature, true);
+    }
+}
+
+} // namespace Benchmarks
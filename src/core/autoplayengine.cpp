@@ -0,0 +1,160 @@
+#include "autoplayengine.h"
+
+// STL includes
+#include <algorithm>
+
+// Project includes
+#include "../utils/constants.h"
+
+AutoplayEngine::AutoplayEngine(const IProcessMemory& process, const AutoplayAddresses& addresses,
+                               const AutoplayRules& rules, AutoplayMetrics& metrics)
+    : m_process(process)
+    , m_addresses(addresses)
+    , m_rules(rules)
+    , m_metrics(metrics)
+    , m_stopRequested(false)
+    , m_timers(1, Constants::AUTOPLAY_TIMER_SLOTS, Clock::now())
+    , m_pendingValue(-1)
+    , m_target(0)
+    , m_wasPlaying(false)
+    , m_wasTimePositive(false)
+    , m_previousWanted(0)
+    , m_armedThisLevel(false)
+    , m_previousReadAt(Clock::now())
+    , m_idleInterval(Constants::AUTOPLAY_CHECK_INTERVAL)
+{
+}
+
+void AutoplayEngine::stop()
+{
+    m_stopRequested = true;
+    m_process.interruptWait();
+}
+
+AutoplayEngine::ExitReason AutoplayEngine::run()
+{
+    while (!m_stopRequested.load()) {
+        int interval = tick();
+
+        if (m_process.waitForExit(interval)) {
+            return ExitReason::ProcessExited;
+        }
+    }
+
+    int autoplayValue = 0;
+    m_process.write(m_addresses.autoplay, &autoplayValue, sizeof(autoplayValue));
+    return ExitReason::Stopped;
+}
+
+// Reads the game state, corrects the flag if needed and returns how long to
+// wait before the next tick
+int AutoplayEngine::tick()
+{
+    m_metrics.ticks.fetch_add(1, std::memory_order_relaxed);
+
+    uint8_t isPlaying = 0;
+    double time = 0.0;
+    int current = 0;
+
+    ReadSpan spans[] = {
+        {m_addresses.isPlaying, sizeof(isPlaying), &isPlaying, 0},
+        {m_addresses.time, sizeof(time), &time, 0},
+        {m_addresses.autoplay, sizeof(current), &current, 0}
+    };
+
+    const Clock::time_point readStart = Clock::now();
+    const bool readOk = (m_process.readBatch(spans, 3) == 3);
+    const Clock::time_point now = Clock::now();
+    m_metrics.readLatency.record(static_cast<uint64_t>(std::chrono::nanoseconds(now - readStart).count()));
+
+    const Clock::time_point previousReadAt = m_previousReadAt;
+    m_previousReadAt = now;
+
+    if (!readOk) {
+        return Constants::AUTOPLAY_IDLE_INTERVAL;
+    }
+
+    const bool playing = (isPlaying == 1);
+    const bool timePositive = (time > 0.0);
+
+    if (playing && !m_wasPlaying) {
+        m_armedThisLevel = false;
+    } else if (!playing && m_wasPlaying && !m_armedThisLevel) {
+        m_metrics.missedTransitions.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (playing != m_wasPlaying) {
+        m_idleInterval = Constants::AUTOPLAY_CHECK_INTERVAL;
+    }
+
+    const AutoplayRules::Action& action = m_rules.evaluate(
+        AutoplayRules::inputsFor(playing, timePositive, m_wasPlaying, m_wasTimePositive));
+    m_wasPlaying = playing;
+    m_wasTimePositive = timePositive;
+
+    // An immediate action overrides anything pending; a delayed one keeps an
+    // identical timer already running so level rules don't restart it
+    if (action.value >= 0) {
+        if (action.delayMs == 0) {
+            m_timers.cancelAll();
+            m_target = action.value;
+        } else if (m_timers.pending() == 0 || m_pendingValue != action.value) {
+            m_timers.cancelAll();
+            m_timers.schedule(now + std::chrono::milliseconds(action.delayMs), action.value);
+            m_pendingValue = action.value;
+        }
+    }
+
+    bool firedByTimer = false;
+    m_expired.clear();
+    m_timers.advance(now, m_expired);
+    for (const TimerWheel::Timer& timer : m_expired) {
+        m_target = timer.value;
+        firedByTimer = true;
+    }
+
+    const int wanted = m_target;
+
+    // The game resets the flag itself on some transitions, so the current
+    // value is compared rather than the last one written
+    if (current != wanted) {
+        if (m_process.write(m_addresses.autoplay, &wanted, sizeof(wanted))) {
+            m_metrics.writes.fetch_add(1, std::memory_order_relaxed);
+
+            // Only the write that arms a level counts towards latency, not
+            // repairs of a flag the game reset
+            if (wanted == 1 && m_previousWanted == 0) {
+                const Clock::time_point written = Clock::now();
+                m_metrics.detectToWrite.record(static_cast<uint64_t>(std::chrono::nanoseconds(written - now).count()));
+                m_metrics.reactionBound.record(static_cast<uint64_t>(std::chrono::nanoseconds(written - previousReadAt).count()));
+                if (!firedByTimer && time > Constants::AUTOPLAY_LATE_ARM_TIME) {
+                    m_metrics.lateArms.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    if (wanted == 1) {
+        m_armedThisLevel = true;
+    }
+    m_previousWanted = wanted;
+
+    const int untilTimer = m_timers.msUntilNext(now);
+
+    if (playing && !wanted) {
+        // Level is loading or counting in: poll fast so the flag lands on the
+        // first tick it can, or sleep up to a pending timer
+        if (untilTimer >= 0) {
+            return std::clamp(untilTimer, Constants::AUTOPLAY_FAST_INTERVAL, Constants::AUTOPLAY_CHECK_INTERVAL);
+        }
+        return Constants::AUTOPLAY_FAST_INTERVAL;
+    }
+
+    int interval = Constants::AUTOPLAY_CHECK_INTERVAL;
+    if (!playing) {
+        // In menus the interval doubles on every quiet tick up to the idle cap
+        interval = m_idleInterval;
+        m_idleInterval = std::min(m_idleInterval * 2, Constants::AUTOPLAY_IDLE_INTERVAL);
+    }
+
+    return (untilTimer >= 0) ? std::min(interval, std::max(untilTimer, 1)) : interval;
+}
@@ -0,0 +1,81 @@
+#ifndef AUTOPLAYENGINE_H
+#define AUTOPLAYENGINE_H
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Project includes
+#include "autoplayrules.h"
+#include "timerwheel.h"
+#include "../platform/processmemory.h"
+#include "../utils/latencyhistogram.h"
+
+struct AutoplayAddresses {
+    uintptr_t autoplay;
+    uintptr_t isPlaying;
+    uintptr_t time;
+};
+
+// Timing of the autoplay loop; owned by the caller so it can outlive single
+// engine runs and be read from other threads while the engine records
+struct AutoplayMetrics {
+    LatencyHistogram readLatency;    // One tick's batched read
+    LatencyHistogram detectToWrite;  // Read that saw the level start -> flag write returned
+    LatencyHistogram reactionBound;  // Previous read -> flag write returned; upper bound from the in-game flip
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> writes{0};
+    std::atomic<uint64_t> missedTransitions{0};  // Levels that started and ended without the flag being set
+    std::atomic<uint64_t> lateArms{0};           // Flag set with song time already past AUTOPLAY_LATE_ARM_TIME
+};
+
+// Drives the game's autoplay flag from isPlaying/time through the version's
+// compiled rules. Between ticks it sleeps inside
+// IProcessMemory::waitForExit(), so a closing game or a stop request ends
+// the loop at once instead of on the next poll. Delayed rule actions wait on
+// a timer wheel that caps the next sleep, never on the thread itself. The
+// poll interval adapts to the game state and the flag is only written when
+// the game's value differs from the wanted one
+class AutoplayEngine
+{
+public:
+    enum class ExitReason { Stopped, ProcessExited };
+
+    AutoplayEngine(const IProcessMemory& process, const AutoplayAddresses& addresses, const AutoplayRules& rules,
+                   AutoplayMetrics& metrics);
+
+    // Blocks the calling thread until stop() or the game exits. On stop the
+    // flag is cleared before returning
+    ExitReason run();
+
+    // Safe from any thread
+    void stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int tick();
+
+    const IProcessMemory& m_process;
+    const AutoplayAddresses m_addresses;
+    const AutoplayRules m_rules;
+    AutoplayMetrics& m_metrics;
+
+    std::atomic<bool> m_stopRequested;
+
+    TimerWheel m_timers;
+    std::vector<TimerWheel::Timer> m_expired;
+    int m_pendingValue;
+    int m_target;
+
+    bool m_wasPlaying;
+    bool m_wasTimePositive;
+    int m_previousWanted;
+    bool m_armedThisLevel;
+    Clock::time_point m_previousReadAt;
+    int m_idleInterval;
+};
+
+#endif // AUTOPLAYENGINE_H
@@ -0,0 +1,31 @@
+#include "autoplayrules.h"
+
+AutoplayRules::AutoplayRules()
+{
+    m_table.fill({-1, 0});
+}
+
+AutoplayRules AutoplayRules::compile(const std::vector<AutoplayRule>& rules)
+{
+    AutoplayRules compiled;
+
+    for (uint8_t state = 0; state < AutoplayInput::STATE_COUNT; ++state) {
+        for (const AutoplayRule& rule : rules) {
+            if ((state & rule.careMask) == (rule.valueMask & rule.careMask)) {
+                compiled.m_table[state] = {static_cast<int8_t>(rule.value ? 1 : 0), rule.delayMs};
+                break;
+            }
+        }
+    }
+
+    return compiled;
+}
+
+std::vector<AutoplayRule> AutoplayRules::defaultRules()
+{
+    const uint8_t playing = AutoplayInput::IS_PLAYING | AutoplayInput::TIME_POSITIVE;
+    return {
+        {playing, playing, 1, 0},
+        {0, 0, 0, 0}
+    };
+}
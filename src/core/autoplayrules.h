@@ -0,0 +1,69 @@
+#ifndef AUTOPLAYRULES_H
+#define AUTOPLAYRULES_H
+
+// STL includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Inputs sampled by the autoplay engine on every tick, as bits of a 5-bit
+// state. Edges compare against the previous tick
+namespace AutoplayInput {
+    constexpr uint8_t IS_PLAYING = 1 << 0;
+    constexpr uint8_t TIME_POSITIVE = 1 << 1;
+    constexpr uint8_t PLAYING_ROSE = 1 << 2;
+    constexpr uint8_t PLAYING_FELL = 1 << 3;
+    constexpr uint8_t TIME_ROSE = 1 << 4;
+
+    constexpr size_t STATE_COUNT = 32;
+}
+
+// One rule as written in config.json: when the inputs selected by careMask
+// equal valueMask, set the flag to value, optionally after delayMs
+struct AutoplayRule {
+    uint8_t careMask;
+    uint8_t valueMask;
+    int value;
+    uint32_t delayMs;
+};
+
+// Rules compiled into a truth table over every input state. Compiling
+// resolves first-match order once, so evaluating a tick is one table load
+// with no branching on the rules
+class AutoplayRules
+{
+public:
+    struct Action {
+        int8_t value;     // -1 keeps the current target
+        uint32_t delayMs; // 0 applies the value on this tick
+    };
+
+    AutoplayRules();
+
+    // Adopts an already compiled table, e.g. from the compiled config
+    explicit AutoplayRules(const std::array<Action, AutoplayInput::STATE_COUNT>& table) : m_table(table) {}
+
+    static AutoplayRules compile(const std::vector<AutoplayRule>& rules);
+
+    // Autoplay on while a level is playing with its clock running
+    static std::vector<AutoplayRule> defaultRules();
+
+    const Action& evaluate(uint8_t inputs) const { return m_table[inputs & (AutoplayInput::STATE_COUNT - 1)]; }
+    const std::array<Action, AutoplayInput::STATE_COUNT>& getTable() const { return m_table; }
+
+    static uint8_t inputsFor(bool isPlaying, bool timePositive, bool wasPlaying, bool wasTimePositive)
+    {
+        return static_cast<uint8_t>(
+            (isPlaying ? AutoplayInput::IS_PLAYING : 0) |
+            (timePositive ? AutoplayInput::TIME_POSITIVE : 0) |
+            ((isPlaying && !wasPlaying) ? AutoplayInput::PLAYING_ROSE : 0) |
+            ((!isPlaying && wasPlaying) ? AutoplayInput::PLAYING_FELL : 0) |
+            ((timePositive && !wasTimePositive) ? AutoplayInput::TIME_ROSE : 0));
+    }
+
+private:
+    std::array<Action, AutoplayInput::STATE_COUNT> m_table;
+};
+
+#endif // AUTOPLAYRULES_H
@@ -0,0 +1,72 @@
+#include "builtinsignatures.h"
+
+// STL includes
+#include <vector>
+
+// Project includes
+#include "staticpatternmatcher.h"
+#include "builtinsignatures_generated.h"
+
+namespace {
+
+struct Entry {
+    const char* name;
+    BytePattern pattern;
+    PatternMatcher::Compare compare;
+};
+
+template <typename Pattern>
+Entry entryFor()
+{
+    Entry entry = {Pattern::NAME, BytePattern(), &StaticPatternMatcher<Pattern>::matchesAt};
+    BytePattern::fromValues(std::vector<int>(Pattern::BYTES.begin(), Pattern::BYTES.end()), entry.pattern);
+    return entry;
+}
+
+template <typename... Patterns>
+std::vector<Entry> entriesFor(SignatureList<Patterns...>)
+{
+    return {entryFor<Patterns>()...};
+}
+
+const std::vector<Entry>& entries()
+{
+    static const std::vector<Entry> list = entriesFor(BuiltinSignaturePatterns::BuiltinSignatureList{});
+    return list;
+}
+
+} // namespace
+
+namespace BuiltinSignatures {
+
+PatternMatcher::Compare find(const BytePattern& pattern)
+{
+    for (const Entry& entry : entries()) {
+        if (entry.pattern == pattern) {
+            return entry.compare;
+        }
+    }
+    return nullptr;
+}
+
+size_t count()
+{
+    return entries().size();
+}
+
+const BytePattern& pattern(size_t index)
+{
+    return entries()[index].pattern;
+}
+
+const char* name(size_t index)
+{
+    return entries()[index].name;
+}
+
+PatternMatcher::Compare compare(size_t index)
+{
+    return entries()[index].compare;
+}
+
+} // namespace BuiltinSignatures
@@ -0,0 +1,26 @@
+#ifndef BUILTINSIGNATURES_H
+#define BUILTINSIGNATURES_H
+
+// STL includes
+#include <cstddef>
+
+// Project includes
+#include "bytepattern.h"
+#include "patternmatcher.h"
+
+// Signatures config.json held when the app was built, each with a compare
+// specialized at compile time. Configs downloaded later may carry other
+// patterns; those keep the generic compare
+namespace BuiltinSignatures {
+    // Specialized compare for exactly this pattern, or nullptr
+    PatternMatcher::Compare find(const BytePattern& pattern);
+
+    size_t count();
+
+    // Index below count(); name is the first configuration using the pattern
+    const BytePattern& pattern(size_t index);
+    const char* name(size_t index);
+    PatternMatcher::Compare compare(size_t index);
+}
+
+#endif // BUILTINSIGNATURES_H
@@ -0,0 +1,150 @@
+#include "bytepattern.h"
+
+// STL includes
+#include <cstring>
+
+BytePattern::BytePattern(const uint8_t* values, const uint8_t* mask, size_t size)
+{
+    assign(values, mask, size);
+}
+
+bool BytePattern::fromValues(const std::vector<int>& bytes, BytePattern& pattern)
+{
+    std::vector<uint8_t> values(bytes.size(), 0);
+    std::vector<uint8_t> mask(bytes.size(), 0);
+
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (bytes[i] == -1) {
+            continue;
+        }
+        if (bytes[i] < 0 || bytes[i] > 255) {
+            return false;
+        }
+        values[i] = static_cast<uint8_t>(bytes[i]);
+        mask[i] = 0xFF;
+    }
+
+    pattern.assign(values.data(), mask.data(), bytes.size());
+    return true;
+}
+
+bool BytePattern::parse(const std::string& text, BytePattern& pattern, std::string* error)
+{
+    auto hexDigit = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    std::vector<uint8_t> values;
+    std::vector<uint8_t> mask;
+    size_t pos = 0;
+
+    while (pos < text.size()) {
+        if (text[pos] == ' ' || text[pos] == '\t') {
+            ++pos;
+            continue;
+        }
+
+        size_t end = pos;
+        while (end < text.size() && text[end] != ' ' && text[end] != '\t') {
+            ++end;
+        }
+        const std::string token = text.substr(pos, end - pos);
+
+        if (token == "?" || token == "??") {
+            values.push_back(0);
+            mask.push_back(0);
+        } else if (token.size() == 2 && hexDigit(token[0]) >= 0 && hexDigit(token[1]) >= 0) {
+            values.push_back(static_cast<uint8_t>(hexDigit(token[0]) * 16 + hexDigit(token[1])));
+            mask.push_back(0xFF);
+        } else {
+            if (error) {
+                *error = "Invalid pattern token '" + token + "' at column " + std::to_string(pos + 1);
+            }
+            return false;
+        }
+        pos = end;
+    }
+
+    if (values.empty()) {
+        if (error) {
+            *error = "Pattern is empty";
+        }
+        return false;
+    }
+
+    pattern.assign(values.data(), mask.data(), values.size());
+    return true;
+}
+
+void BytePattern::assign(const uint8_t* values, const uint8_t* mask, size_t size)
+{
+    const size_t blocks = (size + sizeof(Block) - 1) / sizeof(Block);
+    m_values.assign(blocks, Block{});
+    m_mask.assign(blocks, Block{});
+    m_runs.clear();
+    m_size = size;
+    m_fixedCount = 0;
+
+    uint8_t* ownValues = reinterpret_cast<uint8_t*>(m_values.data());
+    uint8_t* ownMask = reinterpret_cast<uint8_t*>(m_mask.data());
+
+    for (size_t i = 0; i < size; ++i) {
+        // Wildcards keep value 0, so equal patterns have equal bytes
+        ownMask[i] = mask[i] ? 0xFF : 0x00;
+        ownValues[i] = mask[i] ? values[i] : 0;
+
+        if (!ownMask[i]) {
+            continue;
+        }
+
+        ++m_fixedCount;
+        if (!m_runs.empty() && m_runs.back().offset + m_runs.back().length == i) {
+            ++m_runs.back().length;
+        } else {
+            m_runs.push_back({static_cast<uint32_t>(i), 1});
+        }
+    }
+}
+
+bool BytePattern::matchesAt(const uint8_t* data) const
+{
+    const uint8_t* ownValues = values();
+    for (const Run& run : m_runs) {
+        if (std::memcmp(data + run.offset, ownValues + run.offset, run.length) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string BytePattern::toString() const
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    std::string text;
+    text.reserve(m_size * 3);
+    for (size_t i = 0; i < m_size; ++i) {
+        if (i > 0) {
+            text += ' ';
+        }
+        if (isFixed(i)) {
+            text += digits[values()[i] >> 4];
+            text += digits[values()[i] & 0xF];
+        } else {
+            text += "??";
+        }
+    }
+    return text;
+}
+
+bool BytePattern::operator==(const BytePattern& other) const
+{
+    if (m_size != other.m_size) {
+        return false;
+    }
+    return m_size == 0 ||
+           (std::memcmp(values(), other.values(), m_size) == 0 && std::memcmp(mask(), other.mask(), m_size) == 0);
+}
@@ -0,0 +1,66 @@
+#ifndef BYTEPATTERN_H
+#define BYTEPATTERN_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A signature as parallel value and mask bytes: data byte b matches
+// position i when ((b ^ values()[i]) & mask()[i]) == 0, with mask 0xFF for
+// a fixed byte and 0x00 for a wildcard. Both arrays are 32-byte aligned and
+// zero-padded to a whole vector, and the runs of fixed bytes are found once
+// so a full compare is a few memcmp calls instead of a branch per byte
+class BytePattern
+{
+public:
+    struct Run {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    BytePattern() = default;
+    BytePattern(const uint8_t* values, const uint8_t* mask, size_t size);
+
+    // From config.json's integer form, -1 being the wildcard. Fails on
+    // values outside -1..255
+    static bool fromValues(const std::vector<int>& bytes, BytePattern& pattern);
+
+    // From IDA-style text such as "48 8B ?? ?? 05"; "?" and "??" are
+    // wildcards. Fails on anything else, with the reason in error
+    static bool parse(const std::string& text, BytePattern& pattern, std::string* error = nullptr);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const uint8_t* values() const { return reinterpret_cast<const uint8_t*>(m_values.data()); }
+    const uint8_t* mask() const { return reinterpret_cast<const uint8_t*>(m_mask.data()); }
+    bool isFixed(size_t index) const { return mask()[index] != 0; }
+
+    const std::vector<Run>& fixedRuns() const { return m_runs; }
+    size_t fixedCount() const { return m_fixedCount; }
+
+    // Full compare at data, which must hold size() bytes
+    bool matchesAt(const uint8_t* data) const;
+
+    std::string toString() const;
+
+    bool operator==(const BytePattern& other) const;
+    bool operator!=(const BytePattern& other) const { return !(*this == other); }
+
+private:
+    struct alignas(32) Block {
+        uint8_t bytes[32];
+    };
+
+    void assign(const uint8_t* values, const uint8_t* mask, size_t size);
+
+    std::vector<Block> m_values;
+    std::vector<Block> m_mask;
+    std::vector<Run> m_runs;
+    size_t m_size = 0;
+    size_t m_fixedCount = 0;
+};
+
+#endif // BYTEPATTERN_H
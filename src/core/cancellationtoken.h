@@ -0,0 +1,47 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+// STL includes
+#include <atomic>
+#include <memory>
+
+// Shared stop flag for one piece of work. Copies share the flag, so the
+// owner keeps one and hands copies to the threads doing the work, which
+// check it at chunk granularity. A child is cancelled with its parent but
+// can also be cancelled alone, e.g. a scan that stops its own workers on
+// the first match without stopping the caller
+class CancellationToken
+{
+public:
+    CancellationToken() : m_state(std::make_shared<State>()) {}
+
+    CancellationToken child() const
+    {
+        CancellationToken token;
+        token.m_state->parent = m_state;
+        return token;
+    }
+
+    // A single lock-free store, so it can be called from a signal handler
+    void cancel() const { m_state->cancelled.store(true, std::memory_order_release); }
+
+    bool isCancelled() const
+    {
+        for (const State* state = m_state.get(); state; state = state->parent.get()) {
+            if (state->cancelled.load(std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::shared_ptr<const State> parent;
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+#endif // CANCELLATIONTOKEN_H
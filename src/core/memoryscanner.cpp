@@ -1,101 +1,36 @@
 #include "memoryscanner.h"
 
-MemoryScanner::MemoryRegionScanThread::MemoryRegionScanThread(
-    MemoryScanner* scanner, HANDLE process, const VersionConfig& config,
-    uint8_t* startAddr, uint8_t* endAddr, int threadId)
-    : m_scanner(scanner), m_process(process), m_config(config),
-    m_startAddr(startAddr), m_endAddr(endAddr), m_threadId(threadId)
-{
-    m_result = {threadId, 0, false};
-}
-
-void MemoryScanner::MemoryRegionScanThread::run()
-{
-    PatternMatcher matcher(m_config.autoplayPattern);
-    if (!matcher.isValid()) {
-        return;
-    }
-
-    MEMORY_BASIC_INFORMATION memInfo;
-    uint8_t* address = m_startAddr;
-    std::vector<uint8_t> buffer(Constants::MEMORY_CHUNK_SIZE);
-
-    while (address < m_endAddr && VirtualQueryEx(m_process, address, &memInfo, sizeof(memInfo))) {
-        if (m_scanner->shouldStop()) {
-            return;
-        }
-
-        uint8_t* regionStart = static_cast<uint8_t*>(memInfo.BaseAddress);
-        if (regionStart >= m_endAddr) {
-            break;
-        }
-
-        bool isWritable = (memInfo.State == MEM_COMMIT) && !(memInfo.Protect & (PAGE_NOACCESS | PAGE_GUARD)) &&
-            (memInfo.Protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE));
-
-        if (isWritable && !m_result.found) {
-            size_t regionSize = memInfo.RegionSize;
-
-            if (regionStart + regionSize > m_endAddr) {
-                regionSize = m_endAddr - regionStart;
-                if (regionSize == 0) {
-                    break;
-                }
-            }
-
-            size_t offset = 0;
-            while (offset < regionSize && !m_scanner->shouldStop()) {
-                size_t chunkSize = std::min(Constants::MEMORY_CHUNK_SIZE, regionSize - offset);
-                SIZE_T bytesRead;
-
-                if (ReadProcessMemory(m_process, regionStart + offset, buffer.data(), chunkSize, &bytesRead) && bytesRead > 0) {
-                    if (!m_result.found && bytesRead >= matcher.getPatternSize()) {
-                        size_t foundPos = matcher.search(buffer.data(), bytesRead);
-                        if (foundPos != SIZE_MAX) {
-                            m_result = {m_threadId, reinterpret_cast<uintptr_t>(regionStart) + offset + foundPos, true};
-                            qDebug() << "[LOG] Found pattern at" << Qt::hex << m_result.address;
-                            return;
-                        }
-                    }
-                }
-                offset += chunkSize;
-            }
-        }
-        address = static_cast<uint8_t*>(memInfo.BaseAddress) + memInfo.RegionSize;
-    }
-}
-
-void MemoryScanner::WorkerThread::run()
-{
-    if (m_isAutoplay) {
-        m_scanner->runAutoplay();
-    } else {
-        m_scanner->scanMemory();
-    }
-}
-
 MemoryScanner::MemoryScanner(QObject *parent)
     : QObject(parent)
     , m_state(State::Idle)
     , m_status("Made by Amphibi")
     , m_gameVersion("Not Detected")
     , m_connectionStatus("")
-    , m_shouldStop(false)
     , m_gameWasClosed(false)
-    , m_lastPid(0)
+    , m_addressGeneration(0)
     , m_addressesValid(false)
-    , m_completedScans(0)
     , m_config(std::make_unique<ConfigManager>())
     , m_configLoaded(false)
+    , m_detectingVersion(false)
+    , m_scanFinished(false)
+    , m_taskSerial(0)
+    , m_session(Constants::GAME_PROCESS_NAME)
+    , m_addressCacheLoaded(false)
+    , m_fingerprintsLoaded(false)
+    , m_trackedGeneration(0)
 {
     qRegisterMetaType<quintptr>("quintptr");
     m_addresses.fill(0);
+
+    m_latencyTimer.setInterval(Constants::LATENCY_REFRESH_INTERVAL);
+    connect(&m_latencyTimer, &QTimer::timeout, this, &MemoryScanner::autoplayLatencyChanged);
 }
 
 MemoryScanner::~MemoryScanner()
 {
     stop();
     cleanup();
+    saveLatencyReport();
 }
 
 bool MemoryScanner::isScanning() const
@@ -123,9 +58,54 @@ QString MemoryScanner::connectionStatus() const
     return m_connectionStatus;
 }
 
+void MemoryScanner::setSnapshotPath(const QString& path)
+{
+    m_snapshotPath = path;
+}
+
+QVariantMap MemoryScanner::autoplayLatency() const
+{
+    return latencyReport().toVariantMap();
+}
+
+QJsonObject MemoryScanner::latencyReport() const
+{
+    QJsonObject report;
+    report["ticks"] = static_cast<qint64>(m_autoplayMetrics.ticks.load());
+    report["writes"] = static_cast<qint64>(m_autoplayMetrics.writes.load());
+    report["missed_transitions"] = static_cast<qint64>(m_autoplayMetrics.missedTransitions.load());
+    report["late_arms"] = static_cast<qint64>(m_autoplayMetrics.lateArms.load());
+    report["read"] = histogramToJson(m_autoplayMetrics.readLatency);
+    report["detect_to_write"] = histogramToJson(m_autoplayMetrics.detectToWrite);
+    report["reaction_bound"] = histogramToJson(m_autoplayMetrics.reactionBound);
+    return report;
+}
+
+void MemoryScanner::saveLatencyReport() const
+{
+    if (m_autoplayMetrics.ticks.load() == 0) {
+        return;
+    }
+
+    QJsonObject report = latencyReport();
+    report["app_version"] = Constants::APP_VERSION;
+    report["game_version"] = m_gameVersion;
+
+    QSaveFile file(QDir(QCoreApplication::applicationDirPath()).filePath(Constants::LATENCY_REPORT_FILENAME));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[WARNING] Couldn't write latency report:" << file.errorString();
+        return;
+    }
+
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        qDebug() << "[WARNING] Couldn't write latency report:" << file.errorString();
+    }
+}
+
 bool MemoryScanner::shouldStop() const
 {
-    return m_shouldStop;
+    return m_stopToken.isCancelled();
 }
 
 bool MemoryScanner::loadConfig()
@@ -162,8 +142,8 @@ void MemoryScanner::toggle()
             m_gameWasClosed = false;
 
             if (m_addressesValid) {
-                DWORD currentPid = ProcessManager::getProcessId(Constants::GAME_PROCESS_NAME);
-                if (currentPid != 0 && currentPid == m_lastPid) {
+                // Addresses hold for as long as the process they came from
+                if (m_session.refresh() && m_session.generation() == m_addressGeneration) {
                     startAutoplay();
                     return;
                 } else {
@@ -185,15 +165,12 @@ void MemoryScanner::toggle()
 
 void MemoryScanner::onUpdateDone()
 {
+    // The config itself is parsed by the scan, alongside its other stages
     if (m_state == State::Idle) {
-        if (loadConfig()) {
+        if (isConfigFileExists()) {
             startScan();
         } else {
-            if (!isConfigFileExists()) {
-                updateStatus("Config file not found");
-            } else {
-                updateStatus("Config load failed");
-            }
+            updateStatus("Config file not found");
         }
     }
 }
@@ -213,6 +190,13 @@ void MemoryScanner::setState(State newState)
 
     if ((oldState == State::Autoplay) != (newState == State::Autoplay)) {
         emit inAutoplayChanged(newState == State::Autoplay);
+
+        if (newState == State::Autoplay) {
+            m_latencyTimer.start();
+        } else {
+            m_latencyTimer.stop();
+            emit autoplayLatencyChanged();
+        }
     }
 }
 
@@ -244,30 +228,58 @@ void MemoryScanner::startScan()
 {
     cleanup();
     setState(State::Scanning);
-    m_shouldStop = false;
-
-    m_worker = std::make_unique<WorkerThread>(this, false);
-    connect(m_worker.get(), &QThread::finished, this, [this]() {
-        QTimer::singleShot(0, this, [this]() {
+    m_stopToken = CancellationToken();
+    m_scanFinished = false;
+    m_scanTimer.start();
+
+    const uint64_t serial = ++m_taskSerial;
+    m_task = m_threadPool.submit([this, serial]() {
+        scanMemory();
+        QTimer::singleShot(0, this, [this, serial]() {
+            if (!finishTask(serial)) {
+                return;
+            }
             cleanup();
+            if (m_scanFinished) {
+                m_scanFinished = false;
+                allRegionsComplete();
+            }
         });
     });
-    m_worker->start();
 }
 
 void MemoryScanner::startAutoplay()
 {
     cleanup();
+    launchAutoplay();
+}
+
+void MemoryScanner::launchAutoplay()
+{
+    if (!m_session.refresh()) {
+        m_addressesValid = false;
+        setState(State::Idle);
+        updateStatus("Game not found");
+        updateGameVersion("Not Detected");
+        return;
+    }
+
     setState(State::Autoplay);
-    m_shouldStop = false;
+    m_stopToken = CancellationToken();
 
-    m_worker = std::make_unique<WorkerThread>(this, true);
-    connect(m_worker.get(), &QThread::finished, this, [this]() {
-        QTimer::singleShot(0, this, [this]() {
-            cleanup();
+    m_autoplay = std::make_unique<AutoplayEngine>(*m_session.process(),
+        AutoplayAddresses{m_addresses[0], m_addresses[1], m_addresses[2]},
+        m_currentConfig.autoplayRules, m_autoplayMetrics);
+
+    const uint64_t serial = ++m_taskSerial;
+    m_task = m_threadPool.submit([this, serial]() {
+        runAutoplay();
+        QTimer::singleShot(0, this, [this, serial]() {
+            if (finishTask(serial)) {
+                cleanup();
+            }
         });
     });
-    m_worker->start();
 }
 
 void MemoryScanner::stop()
@@ -276,59 +288,77 @@ void MemoryScanner::stop()
         return;
     }
 
-    if (m_state == State::Autoplay) {
-        auto processHandle = ProcessManager::openProcess(Constants::GAME_PROCESS_NAME,
-            PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_QUERY_INFORMATION);
-        HANDLE process = processHandle.get();
-        if (process) {
-            if (m_addressesValid && m_addresses[0] != 0) {
-                int autoplayValue = 0;
-                SIZE_T bytesWritten;
-                WriteProcessMemory(process, reinterpret_cast<LPVOID>(m_addresses[0]),
-                    &autoplayValue, sizeof(autoplayValue), &bytesWritten);
-            }
-        }
+    // The engine clears the autoplay flag on its way out
+    m_stopToken.cancel();
+    if (m_autoplay) {
+        m_autoplay->stop();
+    } else {
+        interruptWatch();
     }
 
-    m_shouldStop = true;
     setState(State::Idle);
 
     if (!m_gameWasClosed) {
         updateStatus("Made by Amphibi");
     }
+}
 
-    for (auto& thread : m_scanThreads) {
-        if (thread && thread->isRunning()) {
-            thread->quit();
-            if (!thread->wait(Constants::THREAD_QUIT_TIMEOUT)) {
-                thread->terminate();
-                thread->wait(Constants::THREAD_TERMINATE_TIMEOUT);
-            }
+void MemoryScanner::cleanup()
+{
+    // Scans check the token between chunks and autoplay between ticks, so
+    // the task returns promptly and is never killed halfway
+    if (m_task.valid()) {
+        m_stopToken.cancel();
+        if (m_autoplay) {
+            m_autoplay->stop();
+        } else {
+            interruptWatch();
         }
+        m_task.wait();
+        m_task = std::future<void>();
     }
+    m_autoplay.reset();
 }
 
-void MemoryScanner::cleanup()
+bool MemoryScanner::finishTask(uint64_t serial)
 {
-    if (m_worker) {
-        if (m_worker->isRunning()) {
-            m_shouldStop = true;
-            m_worker->quit();
-            if (!m_worker->wait(Constants::THREAD_QUIT_TIMEOUT)) {
-                m_worker->terminate();
-                m_worker->wait(Constants::THREAD_TERMINATE_TIMEOUT);
-            }
-        }
-        m_worker.reset();
+    // A task that was replaced has already been waited for by cleanup()
+    if (serial != m_taskSerial || !m_task.valid()) {
+        return false;
+    }
+
+    // Its last step was queuing this call, so the wait is brief
+    m_task.wait();
+    m_task = std::future<void>();
+    return true;
+}
+
+void MemoryScanner::interruptWatch()
+{
+    // Wakes a watch sleeping between passes. The session only swaps its
+    // backend under the mutex
+    QMutexLocker locker(&m_mutex);
+    if (m_session.isAttached()) {
+        m_session.process()->interruptWait();
     }
 }
 
 void MemoryScanner::scanMemory()
 {
-    m_processHandle = ProcessManager::openProcess(Constants::GAME_PROCESS_NAME,
-        PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_QUERY_INFORMATION);
+    if (!m_snapshotPath.isEmpty()) {
+        std::string error;
+        std::unique_ptr<IProcessMemory> snapshot = SnapshotProcessMemory::open(m_snapshotPath.toStdString(), error);
+        if (!snapshot) {
+            qDebug() << "[ERROR] Failed to open snapshot" << m_snapshotPath << ":" << QString::fromStdString(error);
+        }
+        QMutexLocker locker(&m_mutex);
+        m_session.adopt(std::move(snapshot));
+    } else {
+        QMutexLocker locker(&m_mutex);
+        m_session.attach();
+    }
 
-    if (!m_processHandle.get()) {
+    if (!m_session.isAttached()) {
         QTimer::singleShot(0, this, [this]() {
             updateStatus("Game not found");
             updateGameVersion("Not Detected");
@@ -337,120 +367,475 @@ void MemoryScanner::scanMemory()
         return;
     }
 
-    m_lastPid = ProcessManager::getProcessId(Constants::GAME_PROCESS_NAME);
+    m_addressGeneration = m_session.generation();
+    qDebug() << "[LOG] Attached to PID" << m_session.processId() << "| generation" << m_addressGeneration
+             << "| name lookups:" << m_session.getLookupCount();
     m_gameWasClosed = false;
 
     QTimer::singleShot(0, this, [this]() {
         updateStatus("Getting game version");
     });
 
-    QString processVersion = ProcessManager::computeProcessMD5(m_lastPid);
+    // Hashing the executable, walking the address space and parsing the
+    // config don't depend on each other, so they run side by side and
+    // startup costs the slowest of them rather than their sum
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    qint64 versionMs = -1;
+    qint64 regionsMs = -1;
+
+    // The stages run on the pool and write into these locals, so every way
+    // out of here waits for both first
+    QString md5;
+    std::vector<MemoryRegion> regions;
+    std::future<void> versionStage = m_threadPool.submit([this, &stageTimer, &versionMs, &md5]() {
+        md5 = fingerprintModule();
+        versionMs = stageTimer.elapsed();
+    });
+    std::future<void> regionStage = m_threadPool.submit([this, &stageTimer, &regionsMs, &regions]() {
+        regions = enumerateRegions();
+        regionsMs = stageTimer.elapsed();
+    });
+
+    const bool configLoaded = loadConfig();
+    loadAddressCache();
+    const qint64 configMs = stageTimer.elapsed();
+
+    regionStage.wait();
+
+    if (!configLoaded) {
+        versionStage.wait();
+        const bool configExists = isConfigFileExists();
+        QTimer::singleShot(0, this, [this, configExists]() {
+            updateStatus(configExists ? "Config load failed" : "Config file not found");
+            setState(State::Idle);
+        });
+        return;
+    }
+
+    // A cached fingerprint is usually back by now. If hashing is still
+    // running, every known layout is scanned speculatively meanwhile and
+    // the version decides afterwards which hit to trust
+    const bool speculative = versionStage.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    std::vector<VersionConfig> scanConfigs;
+
+    if (!speculative) {
+        if (!selectVersion(md5)) {
+            return;
+        }
+        if (!m_detectingVersion) {
+            scanConfigs.push_back(m_currentConfig);
+        }
+    } else {
+        QTimer::singleShot(0, this, [this]() {
+            updateStatus("Starting parallel scan...");
+        });
+    }
+
+    if (scanConfigs.empty()) {
+        // Newest entries come first so a shared pattern resolves to the
+        // most recent offsets
+        const QList<VersionConfig>& configurations = m_config->getConfigurations();
+        scanConfigs.assign(configurations.rbegin(), configurations.rend());
+    }
+
+    qDebug() << "[LOG] Startup stages | config:" << configMs << "ms | regions:" << regionsMs << "ms | version:"
+             << (speculative ? QString("pending") : QString::number(versionMs) + " ms");
+
+    if (shouldStop()) {
+        versionStage.wait();
+        return;
+    }
+
+    m_addresses.fill(0);
+    PatternSearchResult result = {0, 0, false};
+    bool found = parallelScan(scanConfigs, regions, !speculative, result);
+
+    if (speculative) {
+        versionStage.wait();
+        if (!selectVersion(md5)) {
+            return;
+        }
+        qDebug() << "[LOG] Version known after" << versionMs << "ms, speculative scan"
+                 << (found ? "hit" : "missed");
+
+        // A hit on another layout's signature can't be trusted for a build
+        // the config knows, so that build's own pattern gets the last word
+        if (found && !m_detectingVersion &&
+            scanConfigs[result.patternIndex].autoplayPattern != m_currentConfig.autoplayPattern) {
+            qDebug() << "[WARNING] Speculative hit belongs to" << scanConfigs[result.patternIndex].displayName
+                     << "| rescanning for" << m_currentConfig.displayName;
+            scanConfigs.assign(1, m_currentConfig);
+            found = !shouldStop() && parallelScan(scanConfigs, regions, true, result);
+        }
+
+        // The watch below must only accept the known build's own signature.
+        // The miss covered that layout too, so the regions it searched stay
+        // tracked for it
+        if (!found && !m_detectingVersion) {
+            scanConfigs.assign(1, m_currentConfig);
+            m_trackedLayouts = m_currentConfig.displayName;
+        }
+    }
+
+    // A miss usually means the level isn't loaded yet
+    if (!found && !shouldStop() && m_snapshotPath.isEmpty()) {
+        found = watchForPattern(scanConfigs, regions, result);
+    }
+
+    if (found) {
+        if (m_detectingVersion) {
+            m_currentConfig = scanConfigs[result.patternIndex];
+        }
+
+        m_addresses[0] = result.address;
+        m_addresses[1] = result.address - m_currentConfig.isPlayingOffset;
+        m_addresses[2] = result.address - m_currentConfig.timeOffset;
+
+        qDebug() << "[LOG] Found addresses"
+            << "| Autoplay:" << Qt::hex << m_addresses[0]
+            << "| IsPlaying:" << Qt::hex << m_addresses[1]
+            << "| Time:" << Qt::hex << m_addresses[2];
+
+        cacheLocation(regions, result.address);
+
+        // Autoplay needs none of it
+        m_bufferPool.trim();
+    }
+
+    m_scanFinished = true;
+}
+
+bool MemoryScanner::selectVersion(const QString& processVersion)
+{
     qDebug() << "[LOG] Process MD5:" << processVersion;
+    m_processVersion = processVersion;
 
     if (processVersion.isEmpty()) {
         QTimer::singleShot(0, this, [this]() {
             updateStatus("Failed to get version");
             setState(State::Idle);
         });
-        return;
+        return false;
     }
 
     auto config = m_config->getVersionConfig(processVersion);
-    if (!config.has_value()) {
+
+    if (config.has_value()) {
+        m_detectingVersion = false;
+        m_currentConfig = config.value();
+
+        QTimer::singleShot(0, this, [this]() {
+            updateGameVersion(m_currentConfig.displayName);
+            updateStatus("Starting parallel scan...");
+        });
+        return true;
+    }
+
+    // Unknown build: look for every known signature in one pass and take
+    // the version from whichever layout is found
+    if (m_config->getConfigurations().isEmpty()) {
         QTimer::singleShot(0, this, [this]() {
             updateStatus("Version isn't supported");
             setState(State::Idle);
         });
-        return;
+        return false;
     }
 
-    m_currentConfig = config.value();
+    m_detectingVersion = true;
+    qDebug() << "[LOG] Unknown MD5, detecting version from" << m_config->getConfigurations().size() << "configurations";
 
     QTimer::singleShot(0, this, [this]() {
-        updateGameVersion(m_currentConfig.displayName);
-        updateStatus("Starting parallel scan...");
+        updateStatus("Detecting game version...");
     });
+    return true;
+}
 
-    if (m_shouldStop) {
-        return;
+QString MemoryScanner::fingerprintModule()
+{
+    // Snapshots carry the hash of the build they were taken from
+    QString md5 = QString::fromStdString(m_session.process()->moduleMD5());
+    if (!md5.isEmpty()) {
+        return md5;
     }
 
-    parallelScan(m_currentConfig);
+    if (!m_fingerprintsLoaded) {
+        QString cachePath = QDir(QCoreApplication::applicationDirPath()).filePath(Constants::FINGERPRINT_CACHE_FILENAME);
+        if (!m_fingerprints.loadFromFile(cachePath)) {
+            qDebug() << "[WARNING] Fingerprint cache ignored:" << m_fingerprints.getLastError();
+        }
+        m_fingerprintsLoaded = true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const int hitsBefore = m_fingerprints.getHits();
+
+    md5 = m_fingerprints.fingerprint(QString::fromStdString(m_session.process()->modulePath()));
+
+    qDebug() << "[LOG] Game version took" << timer.nsecsElapsed() / 1000000.0 << "ms |"
+             << (m_fingerprints.getHits() > hitsBefore ? "warm (cached)" : "cold (hashed)");
+    return md5;
 }
 
-void MemoryScanner::parallelScan(const VersionConfig& config)
+// Searches new and changed regions again every few hundred ms until the
+// flag turns up, the user stops or the game exits
+bool MemoryScanner::watchForPattern(const std::vector<VersionConfig>& configs, std::vector<MemoryRegion>& regions,
+                                    PatternSearchResult& result)
 {
-    SYSTEM_INFO sysInfo;
-    GetSystemInfo(&sysInfo);
+    QTimer::singleShot(0, this, [this]() {
+        updateStatus("Waiting for the level to load...");
+    });
 
-    uint8_t* memStart = static_cast<uint8_t*>(sysInfo.lpMinimumApplicationAddress);
-    uint8_t* memEnd = static_cast<uint8_t*>(sysInfo.lpMaximumApplicationAddress);
+    QElapsedTimer watchTimer;
+    watchTimer.start();
 
-    uintptr_t totalRange = reinterpret_cast<uintptr_t>(memEnd) - reinterpret_cast<uintptr_t>(memStart);
-    uintptr_t regionSize = totalRange / Constants::NUM_SEARCH_THREADS;
+    for (int pass = 1; watchTimer.elapsed() < Constants::SCAN_WATCH_DURATION; ++pass) {
+        if (m_session.process()->waitForExit(Constants::SCAN_WATCH_INTERVAL)) {
+            m_session.markExited();
+            return false;
+        }
+        if (shouldStop()) {
+            return false;
+        }
 
-    m_scanThreads.clear();
-    m_scanThreads.reserve(Constants::NUM_SEARCH_THREADS);
-    m_completedScans = 0;
-    m_addresses.fill(0);
+        // Sampled hashes can miss a write between the samples
+        if (pass % Constants::SCAN_WATCH_FULL_PASS == 0) {
+            m_regionTracker.reset();
+        }
+
+        regions = enumerateRegions();
+        if (parallelScan(configs, regions, false, result)) {
+            qDebug() << "[LOG] Watch found the pattern after" << watchTimer.elapsed() << "ms," << pass << "passes";
+            return true;
+        }
+    }
 
-    for (int i = 0; i < Constants::NUM_SEARCH_THREADS; ++i) {
-        uint8_t* start = memStart + (i * regionSize);
-        uint8_t* end = (i == Constants::NUM_SEARCH_THREADS - 1) ? memEnd : start + regionSize;
+    qDebug() << "[LOG] Watch gave up after" << watchTimer.elapsed() << "ms";
+    return false;
+}
 
-        auto thread = std::make_unique<MemoryRegionScanThread>(this, m_processHandle.get(), config, start, end, i);
-        connect(thread.get(), &QThread::finished, this, [this, thread = thread.get()]() {
-            regionComplete(thread, m_currentConfig);
-        });
+std::vector<MemoryRegion> MemoryScanner::enumerateRegions() const
+{
+    return RegionScanner::scannableRegions(m_session.process()->enumerateRegions());
+}
 
-        thread->start();
-        m_scanThreads.push_back(std::move(thread));
+void MemoryScanner::loadAddressCache()
+{
+    if (!m_addressCacheLoaded) {
+        QString cachePath = QDir(QCoreApplication::applicationDirPath()).filePath(Constants::ADDRESS_CACHE_FILENAME);
+        if (!m_addressCache.loadFromFile(cachePath)) {
+            qDebug() << "[WARNING] Address cache ignored:" << m_addressCache.getLastError();
+        }
+        m_addressCacheLoaded = true;
     }
 }
 
-void MemoryScanner::regionComplete(MemoryRegionScanThread* completedThread, const VersionConfig& config)
+bool MemoryScanner::parallelScan(const std::vector<VersionConfig>& configs, const std::vector<MemoryRegion>& regions,
+                                 bool useAddressCache, PatternSearchResult& result)
 {
-    QMutexLocker locker(&m_mutex);
+    std::vector<PatternMatcher> matchers;
+    matchers.reserve(configs.size());
+    for (const VersionConfig& config : configs) {
+        matchers.push_back(config.matcher ? *config.matcher : PatternMatcher(config.autoplayPattern));
+    }
+    MultiPatternMatcher matcher(matchers);
 
-    m_completedScans++;
-    auto result = completedThread->getResult();
+    // Regions no layout being looked for can live in are left out, and the
+    // likeliest ones go first
+    RegionHints hints = configs.empty() ? RegionHints() : configs.front().regionHints;
+    for (size_t i = 1; i < configs.size(); ++i) {
+        hints = RegionClassifier::combine(hints, configs[i].regionHints);
+    }
+    const std::vector<MemoryRegion> prioritized = RegionClassifier::prioritize(regions, hints);
 
-    if (result.found && m_addresses[0] == 0) {
-        m_addresses[0] = result.address;
-        m_addresses[1] = result.address - config.isPlayingOffset;
-        m_addresses[2] = result.address - config.timeOffset;
+    // After a miss for the same layouts in the same process, only regions
+    // that are new or changed since can hold the flag
+    QStringList layouts;
+    for (const VersionConfig& config : configs) {
+        layouts.append(config.displayName);
+    }
+    if (layouts.join('\n') != m_trackedLayouts || m_session.generation() != m_trackedGeneration) {
+        m_regionTracker.reset();
+        m_trackedLayouts = layouts.join('\n');
+        m_trackedGeneration = m_session.generation();
+    }
 
-        qDebug() << "[LOG] Found addresses"
-            << "| Autoplay:" << Qt::hex << m_addresses[0]
-            << "| IsPlaying:" << Qt::hex << m_addresses[1]
-            << "| Time:" << Qt::hex << m_addresses[2];
+    const bool incremental = !m_regionTracker.isEmpty();
+    RegionDiffStats diff;
+    const std::vector<MemoryRegion> candidates = m_regionTracker.update(*m_session.process(), prioritized, &diff);
+
+    if (incremental) {
+        qDebug() << "[LOG] Rescanning" << candidates.size() << "of" << prioritized.size() << "regions |"
+                 << diff.added << "new |" << diff.grown << "grown |" << diff.changed << "changed |"
+                 << diff.removed << "gone |" << diff.bytes / (1024 * 1024) << "MB";
+    } else {
+        qDebug() << "[LOG]" << prioritized.size() << "of" << regions.size() << "regions match the region hints";
     }
 
-    if (m_completedScans >= Constants::NUM_SEARCH_THREADS) {
-        QTimer::singleShot(0, this, [this]() {
-            allRegionsComplete();
-        });
+    result = {0, 0, false};
+    std::vector<MemoryRegion> searched;
+    bool found = useAddressCache && scanCachedLocation(candidates, matcher, result, searched);
+
+    if (!found && !shouldStop()) {
+        // Regions the cache lookup already searched in full aren't searched
+        // twice
+        std::vector<uintptr_t> searchedBases;
+        searchedBases.reserve(searched.size());
+        for (const MemoryRegion& region : searched) {
+            searchedBases.push_back(region.base);
+        }
+        std::sort(searchedBases.begin(), searchedBases.end());
+
+        std::vector<MemoryRegion> remaining;
+        remaining.reserve(candidates.size());
+        for (const MemoryRegion& region : candidates) {
+            if (!std::binary_search(searchedBases.begin(), searchedBases.end(), region.base)) {
+                remaining.push_back(region);
+            }
+        }
+
+        found = !remaining.empty() && scanRegions(remaining, matcher, result);
     }
+
+    // A hit starts over next time, and so does a scan cut short, since
+    // its regions weren't all searched
+    if (found || shouldStop()) {
+        m_regionTracker.reset();
+    }
+
+    return found;
 }
 
-void MemoryScanner::allRegionsComplete()
+// Checks the region recorded for this build first: the exact spot, then the
+// same region and regions of the same protection and size class, before
+// the caller falls back to a full scan. Regions searched in full here are
+// added to searched so the fallback can skip them
+bool MemoryScanner::scanCachedLocation(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+                                       PatternSearchResult& result, std::vector<MemoryRegion>& searched)
 {
-    for (auto& thread : m_scanThreads) {
-        if (thread && thread->isRunning()) {
-            thread->quit();
-            thread->wait(Constants::THREAD_TERMINATE_TIMEOUT);
+    auto cached = m_addressCache.lookup(m_processVersion);
+    if (!cached.has_value()) {
+        return false;
+    }
+
+    auto sizeClass = [](uint64_t size) {
+        int bits = 0;
+        while (size > 1) {
+            size >>= 1;
+            ++bits;
+        }
+        return bits;
+    };
+
+    const CachedLocation location = cached.value();
+    std::vector<MemoryRegion> candidates;
+    std::vector<MemoryRegion> sameClass;
+
+    for (const MemoryRegion& region : regions) {
+        if (region.base == location.regionBase) {
+            candidates.push_back(region);
+        } else if (region.protection == location.protect && sizeClass(region.size) == sizeClass(location.regionSize)) {
+            sameClass.push_back(region);
         }
     }
-    m_scanThreads.clear();
 
-    if (m_shouldStop) {
+    bool found = false;
+
+    if (!candidates.empty() && location.offset + matcher.getMaxPatternSize() <= candidates.front().size) {
+        std::vector<uint8_t> buffer(matcher.getMaxPatternSize());
+        uintptr_t address = static_cast<uintptr_t>(location.regionBase + location.offset);
+
+        if (m_session.process()->read(address, buffer.data(), buffer.size()) == buffer.size()) {
+            MultiPatternMatcher::Match match = matcher.search(buffer.data(), buffer.size());
+            if (match.found() && match.offset == 0) {
+                result = {address, match.patternIndex, true};
+                found = true;
+            }
+        }
+    }
+
+    if (!found) {
+        candidates.insert(candidates.end(), sameClass.begin(), sameClass.end());
+        found = !candidates.empty() && scanRegions(candidates, matcher, result);
+        searched.insert(searched.end(), candidates.begin(), candidates.end());
+    }
+
+    m_addressCache.recordLookup(found);
+    if (!m_addressCache.save()) {
+        qDebug() << "[WARNING] Failed to save address cache";
+    }
+    qDebug() << "[LOG] Address cache" << (found ? "hit" : "miss")
+             << "| Hit rate:" << m_addressCache.getHits() << "/" << m_addressCache.getLookups();
+    return found;
+}
+
+void MemoryScanner::cacheLocation(const std::vector<MemoryRegion>& regions, uintptr_t address)
+{
+    for (const MemoryRegion& region : regions) {
+        if (address >= region.base && address < region.base + region.size) {
+            m_addressCache.store(m_processVersion, {region.base, region.size, region.protection, address - region.base});
+            if (!m_addressCache.save()) {
+                qDebug() << "[WARNING] Failed to save address cache";
+            }
+            return;
+        }
+    }
+}
+
+bool MemoryScanner::scanRegions(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+                                PatternSearchResult& result)
+{
+    RegionScanner scanner(*m_session.process(), RegionScanOptions(), &m_bufferPool, &m_threadPool);
+
+    bool found = scanner.scan(regions, matcher, m_stopToken, result);
+
+    const RegionScanStats& stats = scanner.getStats();
+    qDebug() << "[LOG] Scanned" << regions.size() << "regions as" << stats.itemCount
+             << "work items on" << stats.workers.size() << "workers";
+
+    for (const ScanWorkerStats& worker : stats.workers) {
+        qDebug() << "[LOG] Worker" << worker.workerId << "|" << worker.items << "items |"
+                 << worker.bytes / (1024 * 1024) << "MB |" << worker.steals << "steals |"
+                 << worker.wallMs << "ms";
+    }
+
+    if (scanner.getOptions().pipelineDepth >= 2) {
+        qDebug() << "[LOG] Pipeline depth" << scanner.getOptions().pipelineDepth << "|" << stats.stalls
+                 << "stalls waiting on reads";
+    }
+
+    qDebug() << "[LOG] Scan buffers:" << stats.buffers.allocations << "allocated |" << stats.buffers.reuses
+             << "reused |" << stats.buffers.largePageBuffers << "on large pages |"
+             << stats.buffers.bytesHeld / (1024 * 1024) << "MB pooled";
+    qDebug() << "[LOG] Page faults during scan:" << stats.pageFaults << "| Peak RSS:"
+             << stats.peakRss / (1024 * 1024) << "MB | Threads started:" << stats.threadsStarted;
+
+    const double gigabytes = static_cast<double>(stats.bytesScanned) / (1024.0 * 1024.0 * 1024.0);
+    qDebug() << "[LOG] Read syscalls:" << stats.syscalls << "|"
+             << (gigabytes > 0.0 ? stats.syscalls / gigabytes : 0.0) << "per GB scanned";
+
+    if (found) {
+        auto hit = std::find_if(regions.begin(), regions.end(), [&result](const MemoryRegion& region) {
+            return result.address >= region.base && result.address < region.base + region.size;
+        });
+        qDebug() << "[LOG] Found pattern at" << Qt::hex << result.address << Qt::dec << "in"
+                 << (hit != regions.end() ? RegionClassifier::className(RegionClassifier::classify(*hit)) : "unknown")
+                 << "region after" << stats.bytesBeforeHit / (1024 * 1024) << "MB of"
+                 << stats.bytesScanned / (1024 * 1024) << "MB scanned";
+    }
+    return found;
+}
+
+void MemoryScanner::allRegionsComplete()
+{
+    if (shouldStop()) {
         setState(State::Idle);
         updateStatus("Made by Amphibi");
         return;
     }
 
-    DWORD currentPid = ProcessManager::getProcessId(Constants::GAME_PROCESS_NAME);
-    if (currentPid == 0 || currentPid != m_lastPid) {
+    if (!m_session.refresh() || m_session.generation() != m_addressGeneration) {
         m_addressesValid = false;
         m_gameWasClosed = true;
         setState(State::Idle);
@@ -460,107 +845,52 @@ void MemoryScanner::allRegionsComplete()
 
     if (m_addresses[0] != 0) {
         qDebug() << "[LOG] Pattern scanning completed successfully";
+
+        if (m_detectingVersion) {
+            qDebug() << "[LOG] Detected layout of" << m_currentConfig.displayName;
+            updateGameVersion(m_currentConfig.displayName + " (detected)");
+        }
+
+        if (!m_snapshotPath.isEmpty()) {
+            qDebug() << "[LOG] Snapshot scan time:" << m_scanTimer.elapsed() << "ms";
+            setState(State::Idle);
+            updateStatus("Snapshot scan complete");
+            return;
+        }
+
         m_addressesValid = true;
+        qDebug() << "[LOG] Time to autoplay:" << m_scanTimer.elapsed() << "ms";
 
-        setState(State::Autoplay);
-        m_worker = std::make_unique<WorkerThread>(this, true);
-        connect(m_worker.get(), &QThread::finished, this, [this]() {
-            QTimer::singleShot(0, this, [this]() {
-                cleanup();
-            });
-        });
-        m_worker->start();
+        launchAutoplay();
     } else {
         qDebug() << "[LOG] Pattern not found in any memory region";
         m_addressesValid = false;
         setState(State::Idle);
-        updateStatus("Addresses not found");
+        updateStatus(m_detectingVersion ? "Version isn't supported" : "Addresses not found");
     }
 }
 
 void MemoryScanner::runAutoplay()
 {
-    auto processHandle = ProcessManager::openProcess(Constants::GAME_PROCESS_NAME,
-        PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_QUERY_INFORMATION);
-    HANDLE process = processHandle.get();
-    if (!process) {
-        QTimer::singleShot(0, this, [this]() {
-            setState(State::Idle);
-            updateStatus("Game not found");
-            updateGameVersion("Not Detected");
-        });
-        return;
-    }
-
     QTimer::singleShot(0, this, [this]() {
         updateStatus("Autoplay is active");
     });
 
-    const uintptr_t autoplayAddr = m_addresses[0];
-    const uintptr_t isPlayingAddr = m_addresses[1];
-    const uintptr_t timeAddr = m_addresses[2];
-
-    uint8_t prev_isPlaying = 0;
-
-    while (!m_shouldStop && m_state == State::Autoplay) {
-        if (!ProcessManager::isProcessRunning(process)) {
-            QTimer::singleShot(0, this, [this]() {
-                m_gameWasClosed = true;
-                setState(State::Idle);
-                updateStatus("Game was closed");
-                updateGameVersion("Not Detected");
-            });
-            m_addressesValid = false;
-            break;
-        }
-
-        DWORD currentPid = ProcessManager::getProcessId(Constants::GAME_PROCESS_NAME);
-        if (currentPid != m_lastPid) {
-            QTimer::singleShot(0, this, [this]() {
-                m_gameWasClosed = true;
-                setState(State::Idle);
-                updateStatus("Game was closed");
-            });
-            m_addressesValid = false;
-            break;
-        }
-
-        uint8_t isPlaying = 0;
-        double time = 0.0;
-
-        SIZE_T bytesRead;
-        if (ReadProcessMemory(process, reinterpret_cast<LPCVOID>(isPlayingAddr), &isPlaying,
-            sizeof(isPlaying), &bytesRead) && bytesRead == sizeof(isPlaying) &&
-            ReadProcessMemory(process, reinterpret_cast<LPCVOID>(timeAddr), &time,
-            sizeof(time), &bytesRead) && bytesRead == sizeof(time)) {
-
-            int autoplayValue = 0;
-            if (m_gameVersion == "1.311") {
-                if (isPlaying == 1 && prev_isPlaying == 0) {
-                    QThread::msleep(550);
-                }
-                autoplayValue = (isPlaying == 1);
-            } else {
-                autoplayValue = (isPlaying == 1 && time > 0.0);
-            }
-
-            SIZE_T bytesWritten;
-            WriteProcessMemory(process, reinterpret_cast<LPVOID>(autoplayAddr),
-                &autoplayValue, sizeof(autoplayValue), &bytesWritten);
-        }
-
-        for (int i = 0; i < Constants::AUTOPLAY_CHECK_INTERVAL && !m_shouldStop && m_state == State::Autoplay; ++i) {
-            QThread::msleep(1);
-        }
+    AutoplayEngine::ExitReason reason = m_autoplay->run();
+    qDebug() << "[LOG] Autoplay finished |" << m_autoplayMetrics.ticks.load() << "ticks |"
+             << m_autoplayMetrics.writes.load() << "writes | Detect to write p99:"
+             << m_autoplayMetrics.detectToWrite.percentile(99.0) / 1000.0 << "us";
 
-        prev_isPlaying = isPlaying;
-    }
-
-    if (m_addressesValid && m_addresses[0] != 0) {
-        int autoplayValue = 0;
-        SIZE_T bytesWritten;
-        WriteProcessMemory(process, reinterpret_cast<LPVOID>(m_addresses[0]),
-            &autoplayValue, sizeof(autoplayValue), &bytesWritten);
+    if (reason == AutoplayEngine::ExitReason::ProcessExited) {
+        m_session.markExited();
+        m_addressesValid = false;
+        QTimer::singleShot(0, this, [this]() {
+            m_gameWasClosed = true;
+            setState(State::Idle);
+            updateStatus("Game was closed");
+            updateGameVersion("Not Detected");
+        });
+        return;
     }
 
     if (m_state != State::Idle) {
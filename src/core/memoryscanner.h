@@ -4,28 +4,43 @@
 // Qt includes
 #include <QObject>
 #include <QString>
-#include <QThread>
 #include <QMutex>
 #include <QTimer>
 #include <QFile>
 #include <QDir>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QVariantMap>
 
 // STL includes
 #include <vector>
 #include <array>
 #include <memory>
 #include <algorithm>
-
-// System includes
-#include <windows.h>
+#include <future>
 
 // Project includes
+#include "autoplayengine.h"
+#include "cancellationtoken.h"
 #include "patternmatcher.h"
+#include "multipatternmatcher.h"
+#include "regionclassifier.h"
+#include "regionscanner.h"
+#include "regiontracker.h"
+#include "scanbufferpool.h"
+#include "scanthreadpool.h"
+#include "../utils/addresscache.h"
 #include "../utils/configmanager.h"
+#include "../utils/fingerprintcache.h"
+#include "../utils/latencyhistogramjson.h"
 #include "../utils/constants.h"
-#include "../platform/windows/processmanager.h"
+#include "../platform/processmemory.h"
+#include "../platform/processsession.h"
+#include "../platform/snapshot/snapshotprocessmemory.h"
 
 class UpdateManager;
 
@@ -37,6 +52,7 @@ class MemoryScanner : public QObject
     Q_PROPERTY(QString statusText READ statusText NOTIFY statusTextChanged)
     Q_PROPERTY(QString gameVersion READ gameVersion NOTIFY gameVersionChanged)
     Q_PROPERTY(QString connectionStatus READ connectionStatus NOTIFY connectionStatusChanged)
+    Q_PROPERTY(QVariantMap autoplayLatency READ autoplayLatency NOTIFY autoplayLatencyChanged)
 
 public:
     explicit MemoryScanner(QObject *parent = nullptr);
@@ -50,89 +66,101 @@ public:
     QString statusText() const;
     QString gameVersion() const;
     QString connectionStatus() const;
+    QVariantMap autoplayLatency() const;
     void updateConnectionStatus(const QString& status);
 
+    // Scans the given snapshot file instead of the running game. Autoplay is
+    // skipped since there is nothing to drive
+    void setSnapshotPath(const QString& path);
+
 signals:
     void scanningChanged(bool scanning);
     void inAutoplayChanged(bool active);
     void statusTextChanged(const QString& text);
     void connectionStatusChanged(const QString& text);
     void gameVersionChanged(const QString& version);
+    void autoplayLatencyChanged();
     void updateCheckStarted();
 
 private:
     enum class State { Idle, Scanning, Autoplay };
 
-    struct PatternSearchResult {
-        int threadId;
-        uintptr_t address;
-        bool found;
-    };
-
-    class MemoryRegionScanThread : public QThread {
-    public:
-        MemoryRegionScanThread(MemoryScanner* scanner, HANDLE process,
-                                 const VersionConfig& config, uint8_t* startAddr,
-                                 uint8_t* endAddr, int threadId);
-        PatternSearchResult getResult() const { return m_result; }
-    protected:
-        void run() override;
-    private:
-        MemoryScanner* m_scanner;
-        HANDLE m_process;
-        VersionConfig m_config;
-        uint8_t* m_startAddr;
-        uint8_t* m_endAddr;
-        int m_threadId;
-        PatternSearchResult m_result;
-    };
-
-    class WorkerThread : public QThread {
-    public:
-        WorkerThread(MemoryScanner* scanner, bool isAutoplay = false)
-            : m_scanner(scanner), m_isAutoplay(isAutoplay) {}
-    protected:
-        void run() override;
-    private:
-        MemoryScanner* m_scanner;
-        bool m_isAutoplay;
-    };
+    using PatternSearchResult = RegionMatch;
 
     void setState(State newState);
     void updateStatus(const QString& status);
     void updateGameVersion(const QString& version);
     void startScan();
     void startAutoplay();
+    void launchAutoplay();
     void stop();
     void cleanup();
-    void parallelScan(const VersionConfig& config);
-    void regionComplete(MemoryRegionScanThread* thread, const VersionConfig& config);
+    bool finishTask(uint64_t serial);
+    void interruptWatch();
+    bool selectVersion(const QString& processVersion);
+    void loadAddressCache();
+    bool parallelScan(const std::vector<VersionConfig>& configs, const std::vector<MemoryRegion>& regions,
+                      bool useAddressCache, PatternSearchResult& result);
+    bool watchForPattern(const std::vector<VersionConfig>& configs, std::vector<MemoryRegion>& regions,
+                         PatternSearchResult& result);
+    std::vector<MemoryRegion> enumerateRegions() const;
+    bool scanRegions(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+                     PatternSearchResult& result);
+    bool scanCachedLocation(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+                            PatternSearchResult& result, std::vector<MemoryRegion>& searched);
+    void cacheLocation(const std::vector<MemoryRegion>& regions, uintptr_t address);
     void allRegionsComplete();
     bool shouldStop() const;
     void scanMemory();
     void runAutoplay();
     bool loadConfig();
     bool isConfigFileExists() const;
+    QString fingerprintModule();
+    QJsonObject latencyReport() const;
+    void saveLatencyReport() const;
 
     State m_state;
     QString m_status;
     QString m_gameVersion;
     QString m_connectionStatus;
-    bool m_shouldStop;
     bool m_gameWasClosed;
     bool m_addressesValid;
     bool m_configLoaded;
+    bool m_detectingVersion;
+    bool m_scanFinished;
     
-    DWORD m_lastPid;
+    uint64_t m_addressGeneration;
     std::array<uintptr_t, 3> m_addresses;
     
-    std::unique_ptr<WorkerThread> m_worker;
-    std::vector<std::unique_ptr<MemoryRegionScanThread>> m_scanThreads;
+    // Runs the scan and autoplay loops, their startup stages and every
+    // scan's workers and readers, on threads kept from one scan to the next
+    ScanThreadPool m_threadPool;
+    // The running scan or autoplay task, if any, and how many were started
+    std::future<void> m_task;
+    uint64_t m_taskSerial;
+    // Replaced whenever a task starts, cancelled by stop()
+    CancellationToken m_stopToken;
+    std::unique_ptr<AutoplayEngine> m_autoplay;
+    AutoplayMetrics m_autoplayMetrics;
+    QTimer m_latencyTimer;
     QMutex m_mutex;
-    int m_completedScans;
-    ProcessHandle m_processHandle;
+    ProcessSession m_session;
+    QString m_snapshotPath;
 
     std::unique_ptr<ConfigManager> m_config;
+    AddressCache m_addressCache;
+    bool m_addressCacheLoaded;
+    FingerprintCache m_fingerprints;
+    bool m_fingerprintsLoaded;
+    QString m_processVersion;
+    QElapsedTimer m_scanTimer;
+    // Regions searched by the last scan that missed, for the layouts in
+    // m_trackedLayouts in session generation m_trackedGeneration
+    RegionTracker m_regionTracker;
+    // Read buffers kept between scans and watch passes, freed once found
+    ScanBufferPool m_bufferPool;
+    QString m_trackedLayouts;
+    uint64_t m_trackedGeneration;
     VersionConfig m_currentConfig;
 };
 
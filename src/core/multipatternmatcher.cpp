@@ -0,0 +1,199 @@
+#include "multipatternmatcher.h"
+
+// STL includes
+#include <algorithm>
+
+// Project includes
+#include "simd.h"
+
+namespace {
+
+constexpr size_t MAX_SIMD_PATTERNS = 16;
+
+struct AnchorPlan {
+    size_t anchorIndex;
+    uint8_t anchorByte;
+    size_t secondIndex;
+    uint8_t secondByte;
+};
+
+#ifdef BBA_X86_SIMD
+
+// One 32-byte step tests the anchor pair of every pattern before moving on,
+// and survivors are verified in position order so the first hit is leftmost
+BBA_TARGET("avx2")
+size_t searchAvx2(const std::vector<PatternMatcher>& matchers, const AnchorPlan* plans,
+                  const uint8_t* data, size_t candidates, size_t& matched,
+                  size_t& resumeAt, uint64_t& compares)
+{
+    const size_t count = matchers.size();
+    __m256i anchor[MAX_SIMD_PATTERNS];
+    __m256i second[MAX_SIMD_PATTERNS];
+    for (size_t k = 0; k < count; ++k) {
+        anchor[k] = _mm256_set1_epi8(static_cast<char>(plans[k].anchorByte));
+        second[k] = _mm256_set1_epi8(static_cast<char>(plans[k].secondByte));
+    }
+
+    size_t pos = 0;
+    for (; pos + 32 <= candidates; pos += 32) {
+        uint32_t masks[MAX_SIMD_PATTERNS];
+        uint32_t any = 0;
+
+        for (size_t k = 0; k < count; ++k) {
+            __m256i blockAnchor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + plans[k].anchorIndex));
+            __m256i blockSecond = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + plans[k].secondIndex));
+            __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(blockAnchor, anchor[k]), _mm256_cmpeq_epi8(blockSecond, second[k]));
+            masks[k] = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+            any |= masks[k];
+        }
+
+        while (any != 0) {
+            unsigned bit = Simd::countTrailingZeros(any);
+            for (size_t k = 0; k < count; ++k) {
+                if (((masks[k] >> bit) & 1) == 0) {
+                    continue;
+                }
+                ++compares;
+                if (matchers[k].matchesAt(data + pos + bit)) {
+                    matched = k;
+                    return pos + bit;
+                }
+            }
+            any &= any - 1;
+        }
+    }
+
+    resumeAt = pos;
+    return SIZE_MAX;
+}
+
+#endif // BBA_X86_SIMD
+
+} // namespace
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<BytePattern>& patterns)
+    : MultiPatternMatcher(std::vector<PatternMatcher>(patterns.begin(), patterns.end()))
+{
+}
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<PatternMatcher>& matchers)
+    : m_patternCount(matchers.size()), m_minPatternSize(0), m_maxPatternSize(0)
+{
+    m_uniqueOf.assign(matchers.size(), SIZE_MAX);
+
+    for (size_t i = 0; i < matchers.size(); ++i) {
+        const PatternMatcher& candidate = matchers[i];
+        if (!candidate.isValid()) {
+            continue;
+        }
+
+        auto it = std::find_if(m_matchers.begin(), m_matchers.end(), [&](const PatternMatcher& known) {
+            return known.getPattern() == candidate.getPattern();
+        });
+
+        if (it != m_matchers.end()) {
+            m_uniqueOf[i] = static_cast<size_t>(it - m_matchers.begin());
+            continue;
+        }
+
+        m_uniqueOf[i] = m_matchers.size();
+        m_firstIndex.push_back(i);
+        m_matchers.push_back(candidate);
+
+        size_t size = candidate.getPatternSize();
+        m_minPatternSize = (m_minPatternSize == 0) ? size : std::min(m_minPatternSize, size);
+        m_maxPatternSize = std::max(m_maxPatternSize, size);
+    }
+}
+
+std::vector<size_t> MultiPatternMatcher::equivalentPatterns(size_t patternIndex) const
+{
+    std::vector<size_t> indices;
+    if (patternIndex >= m_uniqueOf.size() || m_uniqueOf[patternIndex] == SIZE_MAX) {
+        return indices;
+    }
+
+    for (size_t i = 0; i < m_uniqueOf.size(); ++i) {
+        if (m_uniqueOf[i] == m_uniqueOf[patternIndex]) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+MultiPatternMatcher::Match MultiPatternMatcher::search(const uint8_t* data, size_t dataSize, SearchStats* stats) const
+{
+    if (m_matchers.empty() || dataSize < m_minPatternSize) {
+        return {SIZE_MAX, SIZE_MAX};
+    }
+
+    if (m_matchers.size() == 1) {
+        size_t offset = m_matchers[0].search(data, dataSize, stats);
+        return {offset, offset == SIZE_MAX ? SIZE_MAX : m_firstIndex[0]};
+    }
+
+#ifdef BBA_X86_SIMD
+    const bool anchored = std::all_of(m_matchers.begin(), m_matchers.end(), [](const PatternMatcher& matcher) {
+        return matcher.getCareMask()[matcher.getAnchorIndex()] != 0;
+    });
+
+    if (anchored && m_matchers.size() <= MAX_SIMD_PATTERNS && dataSize >= m_maxPatternSize &&
+        PatternMatcher::activeKernel() == PatternMatcher::Kernel::Avx2) {
+        AnchorPlan plans[MAX_SIMD_PATTERNS];
+        for (size_t k = 0; k < m_matchers.size(); ++k) {
+            const PatternMatcher& matcher = m_matchers[k];
+            plans[k] = {
+                matcher.getAnchorIndex(), matcher.getValueMask()[matcher.getAnchorIndex()],
+                matcher.getSecondAnchorIndex(), matcher.getValueMask()[matcher.getSecondAnchorIndex()]
+            };
+        }
+
+        uint64_t compares = 0;
+        size_t matched = 0;
+        size_t resumeAt = 0;
+        size_t offset = searchAvx2(m_matchers, plans, data, dataSize - m_maxPatternSize + 1,
+                                   matched, resumeAt, compares);
+
+        if (stats) {
+            stats->compares += compares;
+        }
+
+        if (offset != SIZE_MAX) {
+            if (stats) {
+                stats->bytesSearched += offset + m_matchers[matched].getPatternSize();
+            }
+            return {offset, m_firstIndex[matched]};
+        }
+
+        if (stats) {
+            stats->bytesSearched += resumeAt;
+        }
+
+        Match tail = searchEach(data + resumeAt, dataSize - resumeAt, stats);
+        if (tail.found()) {
+            tail.offset += resumeAt;
+        }
+        return tail;
+    }
+#endif
+
+    return searchEach(data, dataSize, stats);
+}
+
+// Fallback that runs every pattern on its own; used for buffers shorter
+// than the longest pattern and on CPUs without AVX2
+MultiPatternMatcher::Match MultiPatternMatcher::searchEach(const uint8_t* data, size_t dataSize, SearchStats* stats) const
+{
+    Match best = {SIZE_MAX, SIZE_MAX};
+    size_t limit = dataSize;
+
+    for (size_t k = 0; k < m_matchers.size(); ++k) {
+        // Only a match starting before the current best can improve on it
+        size_t window = (best.found()) ? std::min(limit, best.offset + m_matchers[k].getPatternSize() - 1) : limit;
+        size_t offset = m_matchers[k].search(data, window, stats);
+        if (offset != SIZE_MAX && offset < best.offset) {
+            best = {offset, m_firstIndex[k]};
+        }
+    }
+    return best;
+}
@@ -0,0 +1,55 @@
+#ifndef MULTIPATTERNMATCHER_H
+#define MULTIPATTERNMATCHER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Project includes
+#include "patternmatcher.h"
+
+// Searches for several wildcard patterns in a single pass. Each distinct
+// pattern is located through its rare anchor pair; all anchors are tested
+// against the same vector block, so the data is read once regardless of
+// how many patterns are loaded
+class MultiPatternMatcher
+{
+public:
+    struct Match {
+        size_t offset;
+        size_t patternIndex;
+
+        bool found() const { return offset != SIZE_MAX; }
+    };
+
+    explicit MultiPatternMatcher(const std::vector<BytePattern>& patterns);
+
+    // Same, from matchers that were already built, e.g. from the compiled
+    // config. Empty matchers stand for empty patterns
+    explicit MultiPatternMatcher(const std::vector<PatternMatcher>& matchers);
+
+    // Leftmost match over all patterns. patternIndex refers to the input
+    // list; identical patterns report the lowest index
+    Match search(const uint8_t* data, size_t dataSize, SearchStats* stats = nullptr) const;
+
+    size_t getPatternCount() const { return m_patternCount; }
+    size_t getMinPatternSize() const { return m_minPatternSize; }
+    size_t getMaxPatternSize() const { return m_maxPatternSize; }
+    bool isValid() const { return !m_matchers.empty(); }
+
+    // Input indices sharing the pattern found at patternIndex
+    std::vector<size_t> equivalentPatterns(size_t patternIndex) const;
+
+private:
+    Match searchEach(const uint8_t* data, size_t dataSize, SearchStats* stats) const;
+
+    std::vector<PatternMatcher> m_matchers;
+    std::vector<size_t> m_firstIndex;
+    std::vector<size_t> m_uniqueOf;
+    size_t m_patternCount;
+    size_t m_minPatternSize;
+    size_t m_maxPatternSize;
+};
+
+#endif // MULTIPATTERNMATCHER_H
@@ -1,18 +1,250 @@
 #include "patternmatcher.h"
 
-PatternMatcher::PatternMatcher(const std::vector<int>& pattern)
-    : m_pattern(pattern), m_patternSize(pattern.size())
+// STL includes
+#include <cstring>
+#include <utility>
+
+// Project includes
+#include "simd.h"
+
+namespace {
+
+// Relative byte frequencies for 64-bit process heaps: zero fill, small
+// integers, pointer high bytes (0x7F), all-ones and the exponent bytes of
+// common doubles/floats dominate, while high-bit bytes are rare
+constexpr std::array<uint8_t, 256> HEAP_BYTE_FREQUENCY = {
+    255, 224, 206, 194, 190, 168, 165, 162, 186, 156, 153, 150, 164, 144, 141, 138,
+    176, 112, 111, 110, 109, 108, 107, 106, 120, 104, 103, 102, 101, 100,  99,  98,
+    162,  70,  70,  70,  70,  70,  70,  70, 106,  70,  70,  70,  70,  70,  90,  86,
+    114,  92,  92,  92,  92,  92,  92,  92, 100,  92,  80,  70,  70,  70,  70, 150,
+    158, 112,  88,  88,  88, 100,  88,  88, 104,  88,  88,  88,  88,  88,  88,  88,
+     98,  88,  88,  88,  88,  88,  88,  88,  88,  88,  88,  70,  70,  70,  70,  84,
+     96, 118, 105, 105, 105, 118, 105, 105, 105, 118, 105, 105, 105, 105, 118, 118,
+    105, 105, 118, 118, 118, 105, 105, 105, 105, 105, 105,  70,  70,  70,  70, 178,
+    148,  60,  30,  30,  30,  30,  30,  30,  60,  30,  30,  60,  30,  30,  30,  30,
+     60,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+     60,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+     60,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    128,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30, 100,  30,  30,  30,
+     60,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,
+    118,  30,  30,  30,  30,  30,  30,  30,  60,  30,  30,  30,  30,  30,  30,  30,
+    140,  30,  30,  30,  30,  30,  30,  30, 104,  30,  30,  30, 102,  30, 136, 232,
+};
+
+struct SearchPlan {
+    const uint8_t* values;
+    const uint8_t* care;
+    size_t size;
+    size_t anchorIndex;
+    uint8_t anchorByte;
+    size_t secondIndex;
+    uint8_t secondByte;
+    PatternMatcher::Compare compare;
+};
+
+inline bool maskedEqual(const uint8_t* data, const uint8_t* values, const uint8_t* care, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        if ((data[i] ^ values[i]) & care[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef BBA_X86_SIMD
+
+BBA_TARGET("avx2")
+bool maskedEqualAvx2(const uint8_t* data, const SearchPlan& plan)
+{
+    size_t i = 0;
+    for (; i + 32 <= plan.size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plan.values + i));
+        __m256i care = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(plan.care + i));
+        if (!_mm256_testz_si256(_mm256_xor_si256(block, values), care)) {
+            return false;
+        }
+    }
+    return maskedEqual(data + i, plan.values + i, plan.care + i, plan.size - i);
+}
+
+// Filters 32 candidate positions per step on the two anchor bytes, then
+// verifies the survivors against the value/care masks
+BBA_TARGET("avx2")
+size_t searchAvx2(const SearchPlan& plan, const uint8_t* data, size_t dataSize, size_t& resumeAt, uint64_t& compares)
+{
+    const size_t candidates = dataSize - plan.size + 1;
+    const __m256i anchor = _mm256_set1_epi8(static_cast<char>(plan.anchorByte));
+    const __m256i second = _mm256_set1_epi8(static_cast<char>(plan.secondByte));
+
+    size_t pos = 0;
+    for (; pos + 32 <= candidates; pos += 32) {
+        __m256i blockAnchor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + plan.anchorIndex));
+        __m256i blockSecond = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + plan.secondIndex));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(blockAnchor, anchor), _mm256_cmpeq_epi8(blockSecond, second));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+
+        while (mask != 0) {
+            unsigned bit = Simd::countTrailingZeros(mask);
+            ++compares;
+            if (plan.compare ? plan.compare(data + pos + bit) : maskedEqualAvx2(data + pos + bit, plan)) {
+                return pos + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    resumeAt = pos;
+    return SIZE_MAX;
+}
+
+BBA_TARGET("sse4.2")
+bool maskedEqualSse42(const uint8_t* data, const SearchPlan& plan)
+{
+    size_t i = 0;
+    for (; i + 16 <= plan.size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.values + i));
+        __m128i care = _mm_loadu_si128(reinterpret_cast<const __m128i*>(plan.care + i));
+        if (!_mm_testz_si128(_mm_xor_si128(block, values), care)) {
+            return false;
+        }
+    }
+    return maskedEqual(data + i, plan.values + i, plan.care + i, plan.size - i);
+}
+
+BBA_TARGET("sse4.2")
+size_t searchSse42(const SearchPlan& plan, const uint8_t* data, size_t dataSize, size_t& resumeAt, uint64_t& compares)
+{
+    const size_t candidates = dataSize - plan.size + 1;
+    const __m128i anchor = _mm_set1_epi8(static_cast<char>(plan.anchorByte));
+    const __m128i second = _mm_set1_epi8(static_cast<char>(plan.secondByte));
+
+    size_t pos = 0;
+    for (; pos + 16 <= candidates; pos += 16) {
+        __m128i blockAnchor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + plan.anchorIndex));
+        __m128i blockSecond = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + plan.secondIndex));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(blockAnchor, anchor), _mm_cmpeq_epi8(blockSecond, second));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+
+        while (mask != 0) {
+            unsigned bit = Simd::countTrailingZeros(mask);
+            ++compares;
+            if (plan.compare ? plan.compare(data + pos + bit) : maskedEqualSse42(data + pos + bit, plan)) {
+                return pos + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    resumeAt = pos;
+    return SIZE_MAX;
+}
+
+PatternMatcher::Kernel detectKernel()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse42 = (info[2] & (1 << 20)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf < 7) {
+        return sse42 ? PatternMatcher::Kernel::Sse42 : PatternMatcher::Kernel::Scalar;
+    }
+
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    const bool ymmEnabled = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+
+    if (avx2 && ymmEnabled) {
+        return PatternMatcher::Kernel::Avx2;
+    }
+    return sse42 ? PatternMatcher::Kernel::Sse42 : PatternMatcher::Kernel::Scalar;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return PatternMatcher::Kernel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return PatternMatcher::Kernel::Sse42;
+    }
+    return PatternMatcher::Kernel::Scalar;
+#endif
+}
+
+#else
+
+PatternMatcher::Kernel detectKernel()
+{
+    return PatternMatcher::Kernel::Scalar;
+}
+
+#endif // BBA_X86_SIMD
+
+} // namespace
+
+PatternMatcher::PatternMatcher(const BytePattern& pattern)
+    : m_pattern(pattern), m_patternSize(pattern.size()), m_anchor{0, 0}, m_hasFixed(pattern.fixedCount() > 0)
 {
     buildBadCharTable();
+    selectAnchors();
+}
+
+PatternMatcher::PatternMatcher(const Tables& tables)
+    : m_pattern(tables.valueMask, tables.careMask, tables.size)
+    , m_patternSize(tables.size)
+    , m_anchor{tables.anchorIndex, tables.secondAnchorIndex}
+    , m_hasFixed(m_pattern.fixedCount() > 0)
+{
+    for (size_t i = 0; i < m_badCharTable.size(); ++i) {
+        m_badCharTable[i] = tables.badCharTable[i];
+    }
+}
+
+bool PatternMatcher::matchesAt(const uint8_t* data) const
+{
+    return m_compare ? m_compare(data) : m_pattern.matchesAt(data);
+}
+
+uint8_t PatternMatcher::heapByteFrequency(uint8_t byte)
+{
+    return HEAP_BYTE_FREQUENCY[byte];
+}
+
+PatternMatcher::Kernel PatternMatcher::activeKernel()
+{
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+const char* PatternMatcher::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Kernel::Avx2:
+            return "AVX2";
+        case Kernel::Sse42:
+            return "SSE4.2";
+        case Kernel::Scalar:
+            break;
+    }
+    return "Scalar";
 }
 
 void PatternMatcher::buildBadCharTable()
 {
     m_badCharTable.fill(m_patternSize);
+    if (m_patternSize == 0) {
+        return;
+    }
 
     for (size_t i = 0; i < m_patternSize - 1; ++i) {
-        if (m_pattern[i] != -1) {
-            uint8_t byte = static_cast<uint8_t>(m_pattern[i]);
+        if (m_pattern.isFixed(i)) {
+            uint8_t byte = m_pattern.values()[i];
             m_badCharTable[byte] = m_patternSize - 1 - i;
         } else {
             for (size_t j = 0; j < 256; ++j) {
@@ -24,31 +256,152 @@ void PatternMatcher::buildBadCharTable()
     }
 }
 
-size_t PatternMatcher::search(const uint8_t* data, size_t dataSize) const
+void PatternMatcher::selectAnchors()
+{
+    if (!m_hasFixed) {
+        return;
+    }
+
+    std::vector<size_t> fixed;
+    for (size_t i = 0; i < m_patternSize; ++i) {
+        if (m_pattern.isFixed(i)) {
+            fixed.push_back(i);
+        }
+    }
+
+    if (fixed.size() == 1) {
+        m_anchor = {fixed[0], fixed[0]};
+        return;
+    }
+
+    // Rarest pair by summed frequency; ties go to the pair furthest apart
+    // since neighbouring heap bytes are strongly correlated
+    unsigned bestScore = UINT32_MAX;
+    size_t bestDistance = 0;
+    for (size_t a = 0; a < fixed.size(); ++a) {
+        for (size_t b = a + 1; b < fixed.size(); ++b) {
+            unsigned score = HEAP_BYTE_FREQUENCY[m_pattern.values()[fixed[a]]] + HEAP_BYTE_FREQUENCY[m_pattern.values()[fixed[b]]];
+            size_t distance = fixed[b] - fixed[a];
+            if (score < bestScore || (score == bestScore && distance > bestDistance)) {
+                bestScore = score;
+                bestDistance = distance;
+                m_anchor = {fixed[a], fixed[b]};
+            }
+        }
+    }
+
+    if (HEAP_BYTE_FREQUENCY[m_pattern.values()[m_anchor[1]]] < HEAP_BYTE_FREQUENCY[m_pattern.values()[m_anchor[0]]]) {
+        std::swap(m_anchor[0], m_anchor[1]);
+    }
+}
+
+size_t PatternMatcher::search(const uint8_t* data, size_t dataSize, SearchStats* stats) const
+{
+    if (m_patternSize == 0 || dataSize < m_patternSize) {
+        return SIZE_MAX;
+    }
+
+    if (!m_hasFixed) {
+        return searchScalar(data, dataSize, stats);
+    }
+
+    uint64_t compares = 0;
+    size_t found = SIZE_MAX;
+    size_t resumeAt = 0;
+
+#ifdef BBA_X86_SIMD
+    const Kernel kernel = activeKernel();
+    if (kernel != Kernel::Scalar) {
+        const SearchPlan plan = {
+            m_pattern.values(), m_pattern.mask(), m_patternSize,
+            m_anchor[0], m_pattern.values()[m_anchor[0]],
+            m_anchor[1], m_pattern.values()[m_anchor[1]],
+            m_compare
+        };
+
+        found = (kernel == Kernel::Avx2)
+            ? searchAvx2(plan, data, dataSize, resumeAt, compares)
+            : searchSse42(plan, data, dataSize, resumeAt, compares);
+    }
+#endif
+
+    // Remaining candidates that don't fill a whole vector step
+    if (found == SIZE_MAX) {
+        size_t tail = searchAnchored(data + resumeAt, dataSize - resumeAt, compares);
+        if (tail != SIZE_MAX) {
+            found = resumeAt + tail;
+        }
+    }
+
+    if (stats) {
+        stats->bytesSearched += (found == SIZE_MAX) ? dataSize : found + m_patternSize;
+        stats->compares += compares;
+    }
+    return found;
+}
+
+size_t PatternMatcher::searchAnchored(const uint8_t* data, size_t dataSize, uint64_t& compares) const
+{
+    if (dataSize < m_patternSize) {
+        return SIZE_MAX;
+    }
+
+    const size_t candidates = dataSize - m_patternSize + 1;
+    const uint8_t anchorByte = m_pattern.values()[m_anchor[0]];
+    const uint8_t secondByte = m_pattern.values()[m_anchor[1]];
+
+    size_t pos = 0;
+    while (pos < candidates) {
+        const void* hit = std::memchr(data + pos + m_anchor[0], anchorByte, candidates - pos);
+        if (!hit) {
+            break;
+        }
+
+        pos = static_cast<size_t>(static_cast<const uint8_t*>(hit) - data) - m_anchor[0];
+        if (data[pos + m_anchor[1]] == secondByte) {
+            ++compares;
+            if (matchesAt(data + pos)) {
+                return pos;
+            }
+        }
+        ++pos;
+    }
+
+    return SIZE_MAX;
+}
+
+size_t PatternMatcher::searchScalar(const uint8_t* data, size_t dataSize, SearchStats* stats) const
 {
     if (m_patternSize == 0 || dataSize < m_patternSize) {
         return SIZE_MAX;
     }
 
+    uint64_t compares = 0;
+    size_t found = SIZE_MAX;
     size_t pos = 0;
-    while (pos <= dataSize - m_patternSize) {
+    while (found == SIZE_MAX && pos <= dataSize - m_patternSize) {
         size_t patternPos = m_patternSize - 1;
+        ++compares;
 
         while (true) {
             uint8_t dataByte = data[pos + patternPos];
-            int patternByte = m_pattern[patternPos];
 
-            if (patternByte != -1 && dataByte != static_cast<uint8_t>(patternByte)) {
+            if (m_pattern.isFixed(patternPos) && dataByte != m_pattern.values()[patternPos]) {
                 pos += m_badCharTable[data[pos + m_patternSize - 1]];
                 break;
             }
 
             if (patternPos == 0) {
-                return pos;
+                found = pos;
+                break;
             }
             --patternPos;
         }
     }
 
-    return SIZE_MAX;
+    if (stats) {
+        stats->bytesSearched += (found == SIZE_MAX) ? dataSize : found + m_patternSize;
+        stats->compares += compares;
+    }
+    return found;
 }
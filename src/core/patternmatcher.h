@@ -7,21 +7,84 @@
 #include <array>
 #include <vector>
 
+// Project includes
+#include "bytepattern.h"
+
+struct SearchStats {
+    uint64_t bytesSearched = 0;
+    uint64_t compares = 0;
+};
+
 class PatternMatcher
 {
 public:
-    explicit PatternMatcher(const std::vector<int>& pattern);
+    enum class Kernel { Scalar, Sse42, Avx2 };
+
+    // Full compare generated for one particular pattern
+    using Compare = bool (*)(const uint8_t* data);
+
+    // Everything the constructor derives from a pattern, in the form the
+    // compiled config stores it
+    struct Tables {
+        const uint8_t* valueMask;
+        const uint8_t* careMask;
+        size_t size;
+        size_t anchorIndex;
+        size_t secondAnchorIndex;
+        const uint32_t* badCharTable; // 256 entries
+    };
+
+    explicit PatternMatcher(const BytePattern& pattern);
+
+    // Adopts prebuilt tables instead of deriving them. Indices must lie
+    // inside the pattern
+    explicit PatternMatcher(const Tables& tables);
 
-    size_t search(const uint8_t* data, size_t dataSize) const;
+    size_t search(const uint8_t* data, size_t dataSize, SearchStats* stats = nullptr) const;
+    size_t searchScalar(const uint8_t* data, size_t dataSize, SearchStats* stats = nullptr) const;
     size_t getPatternSize() const { return m_patternSize; }
     bool isValid() const { return m_patternSize > 0; }
 
+    // Full masked compare at data, which must hold getPatternSize() bytes
+    bool matchesAt(const uint8_t* data) const;
+
+    // Replaces the generic compare used to verify candidates. compare must
+    // implement exactly this matcher's pattern; see BuiltinSignatures
+    void setCompare(Compare compare) { m_compare = compare; }
+    bool hasSpecializedCompare() const { return m_compare != nullptr; }
+
+    // Byte-wise form of the pattern: a data byte b matches position i
+    // when ((b ^ valueMask[i]) & careMask[i]) == 0
+    const BytePattern& getPattern() const { return m_pattern; }
+    const uint8_t* getValueMask() const { return m_pattern.values(); }
+    const uint8_t* getCareMask() const { return m_pattern.mask(); }
+
+    // Pattern offsets of the two fixed bytes used to locate candidates,
+    // rarest first. Both are equal when the pattern has one fixed byte
+    size_t getAnchorIndex() const { return m_anchor[0]; }
+    size_t getSecondAnchorIndex() const { return m_anchor[1]; }
+
+    // Horspool shift per last window byte, used by searchScalar()
+    const std::array<size_t, 256>& getBadCharTable() const { return m_badCharTable; }
+
+    // Approximate relative frequency of a byte value in x64 heap data,
+    // 0 being the rarest
+    static uint8_t heapByteFrequency(uint8_t byte);
+
+    static Kernel activeKernel();
+    static const char* kernelName(Kernel kernel);
+
 private:
     void buildBadCharTable();
+    void selectAnchors();
+    size_t searchAnchored(const uint8_t* data, size_t dataSize, uint64_t& compares) const;
 
-    std::vector<int> m_pattern;
+    BytePattern m_pattern;
     std::array<size_t, 256> m_badCharTable;
     size_t m_patternSize;
+    std::array<size_t, 2> m_anchor;
+    bool m_hasFixed;
+    Compare m_compare = nullptr;
 };
 
 #endif // PATTERNMATCHER_H
@@ -0,0 +1,137 @@
+#include "pipelinedreader.h"
+
+// STL includes
+#include <algorithm>
+
+PipelinedReader::PipelinedReader(const IProcessMemory& process, size_t chunkSize, size_t depth, ScanBufferPool& pool,
+                                 ScanThreadPool& threads)
+    : m_process(process)
+    , m_chunkSize(chunkSize)
+    , m_slots(std::max<size_t>(depth, 2))
+    , m_rangeStart(0)
+    , m_rangeSize(0)
+    , m_queued(0)
+    , m_consumed(0)
+    , m_generation(0)
+    , m_holding(false)
+    , m_readerBusy(false)
+    , m_quit(false)
+    , m_stalls(0)
+{
+    m_storage = pool.acquire(m_chunkSize * m_slots.size());
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        Slot& slot = m_slots[i];
+        slot.buffer = m_storage.isValid() ? m_storage.data() + i * m_chunkSize : nullptr;
+        slot.chunk = {0, 0, 0, nullptr};
+        slot.ready = false;
+    }
+    m_readerDone = threads.submit([this]() { readerLoop(); });
+}
+
+PipelinedReader::~PipelinedReader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_readerWake.notify_all();
+    m_consumerWake.notify_all();
+    m_readerDone.wait();
+}
+
+void PipelinedReader::start(uintptr_t address, size_t size)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // A read still in flight belongs to the old range; wait it out so the
+        // slot it writes to can be reused
+        ++m_generation;
+        m_consumerWake.wait(lock, [this]() { return !m_readerBusy; });
+
+        for (Slot& slot : m_slots) {
+            slot.ready = false;
+        }
+        m_rangeStart = address;
+        m_rangeSize = size;
+        m_queued = 0;
+        m_consumed = 0;
+        m_holding = false;
+    }
+    m_readerWake.notify_one();
+}
+
+void PipelinedReader::cancel()
+{
+    start(0, 0);
+}
+
+bool PipelinedReader::next(PipelineChunk& chunk)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const size_t depth = m_slots.size();
+    const size_t total = (m_rangeSize + m_chunkSize - 1) / m_chunkSize;
+
+    if (m_holding) {
+        m_holding = false;
+        m_slots[(m_consumed - 1) % depth].ready = false;
+        m_readerWake.notify_one();
+    }
+
+    if (m_consumed >= total) {
+        return false;
+    }
+
+    Slot& slot = m_slots[m_consumed % depth];
+    if (!slot.ready) {
+        ++m_stalls;
+        m_consumerWake.wait(lock, [&]() { return slot.ready || m_quit; });
+        if (!slot.ready) {
+            return false;
+        }
+    }
+
+    chunk = slot.chunk;
+    ++m_consumed;
+    m_holding = true;
+    return true;
+}
+
+void PipelinedReader::readerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const size_t depth = m_slots.size();
+
+    while (true) {
+        // Chunk i lives in slot i % depth, which is free once the consumer
+        // has moved past chunk i - depth
+        m_readerWake.wait(lock, [&]() {
+            const size_t total = (m_rangeSize + m_chunkSize - 1) / m_chunkSize;
+            const size_t released = m_consumed - (m_holding ? 1 : 0);
+            return m_quit || (m_queued < total && m_queued - released < depth);
+        });
+
+        if (m_quit) {
+            return;
+        }
+
+        const uint64_t generation = m_generation;
+        const size_t index = m_queued;
+        Slot& slot = m_slots[index % depth];
+        const uintptr_t address = m_rangeStart + index * m_chunkSize;
+        const size_t size = std::min(m_chunkSize, m_rangeSize - index * m_chunkSize);
+
+        m_readerBusy = true;
+        lock.unlock();
+        size_t bytesRead = m_process.read(address, slot.buffer, size);
+        lock.lock();
+        m_readerBusy = false;
+
+        if (generation == m_generation) {
+            slot.chunk = {address, size, bytesRead, slot.buffer};
+            slot.ready = true;
+            ++m_queued;
+        }
+        m_consumerWake.notify_all();
+    }
+}
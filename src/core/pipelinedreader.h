@@ -0,0 +1,88 @@
+#ifndef PIPELINEDREADER_H
+#define PIPELINEDREADER_H
+
+// STL includes
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <vector>
+
+// Project includes
+#include "scanbufferpool.h"
+#include "scanthreadpool.h"
+#include "../platform/processmemory.h"
+
+struct PipelineChunk {
+    uintptr_t address;
+    size_t size;
+    size_t bytesRead;
+    const uint8_t* data;
+};
+
+// Streams a range of remote memory through a small ring of buffers, carved
+// out of one lease from a ScanBufferPool.
+// A reader thread copies the next chunks out of the process while the
+// caller searches the current one, so the cross-process copy and the
+// matcher run at the same time instead of taking turns. One consumer
+// thread per reader
+class PipelinedReader
+{
+public:
+    // The reader loop runs on a thread from threads until destruction
+    PipelinedReader(const IProcessMemory& process, size_t chunkSize, size_t depth, ScanBufferPool& pool,
+                    ScanThreadPool& threads);
+    ~PipelinedReader();
+
+    PipelinedReader(const PipelinedReader&) = delete;
+    PipelinedReader& operator=(const PipelinedReader&) = delete;
+
+    // Starts streaming [address, address + size), dropping whatever was
+    // still queued from the previous range
+    void start(uintptr_t address, size_t size);
+
+    // Blocks until the next chunk is filled; returns false once the range is
+    // exhausted. The chunk stays valid until the following call
+    bool next(PipelineChunk& chunk);
+
+    // Stops prefetching the current range
+    void cancel();
+
+    // False when the pool couldn't supply the ring; nothing may be read then
+    bool isValid() const { return m_storage.isValid(); }
+    size_t getDepth() const { return m_slots.size(); }
+    uint64_t getStalls() const { return m_stalls; }
+
+private:
+    struct Slot {
+        uint8_t* buffer;
+        PipelineChunk chunk;
+        bool ready;
+    };
+
+    void readerLoop();
+
+    const IProcessMemory& m_process;
+    const size_t m_chunkSize;
+    ScanBufferPool::Lease m_storage;
+    std::vector<Slot> m_slots;
+
+    std::mutex m_mutex;
+    std::condition_variable m_readerWake;
+    std::condition_variable m_consumerWake;
+
+    uintptr_t m_rangeStart;
+    size_t m_rangeSize;
+    size_t m_queued;      // Chunks handed to the reader for the current range
+    size_t m_consumed;    // Chunks returned by next()
+    uint64_t m_generation;
+    bool m_holding;       // The consumer still holds the slot of m_consumed - 1
+    bool m_readerBusy;
+    bool m_quit;
+    uint64_t m_stalls;
+
+    std::future<void> m_readerDone;
+};
+
+#endif // PIPELINEDREADER_H
@@ -0,0 +1,93 @@
+#include "regionclassifier.h"
+
+// STL includes
+#include <algorithm>
+#include <array>
+
+// Project includes
+#include "../utils/constants.h"
+
+namespace {
+
+constexpr std::array<const char*, static_cast<size_t>(RegionClass::Count)> CLASS_NAMES = {
+    "heap", "private_code", "image_data", "image_code", "mapped", "large_mapped"
+};
+
+} // namespace
+
+RegionClass RegionClassifier::classify(const MemoryRegion& region)
+{
+    const bool writable = (region.protection & (MemoryProtection::WRITE | MemoryProtection::COPY_ON_WRITE)) != 0;
+    const bool executable = (region.protection & MemoryProtection::EXECUTE) != 0;
+
+    switch (region.type) {
+        case RegionType::Image:
+            return writable && !executable ? RegionClass::ImageData : RegionClass::ImageCode;
+        case RegionType::Mapped:
+            return region.size > Constants::SCAN_LARGE_MAPPING_SIZE ? RegionClass::LargeMapped : RegionClass::Mapped;
+        case RegionType::Private:
+            break;
+    }
+    return executable ? RegionClass::PrivateCode : RegionClass::Heap;
+}
+
+const char* RegionClassifier::className(RegionClass regionClass)
+{
+    const size_t index = static_cast<size_t>(regionClass);
+    return index < CLASS_NAMES.size() ? CLASS_NAMES[index] : "unknown";
+}
+
+bool RegionClassifier::parseClassName(const std::string& name, RegionClass& regionClass)
+{
+    for (size_t i = 0; i < CLASS_NAMES.size(); ++i) {
+        if (name == CLASS_NAMES[i]) {
+            regionClass = static_cast<RegionClass>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+RegionHints RegionClassifier::combine(const RegionHints& a, const RegionHints& b)
+{
+    RegionHints combined = a;
+    for (RegionClass regionClass : b.classes) {
+        if (std::find(combined.classes.begin(), combined.classes.end(), regionClass) == combined.classes.end()) {
+            combined.classes.push_back(regionClass);
+        }
+    }
+    combined.minSize = std::min(a.minSize, b.minSize);
+    combined.maxSize = (a.maxSize == 0 || b.maxSize == 0) ? 0 : std::max(a.maxSize, b.maxSize);
+    return combined;
+}
+
+std::vector<MemoryRegion> RegionClassifier::prioritize(const std::vector<MemoryRegion>& regions, const RegionHints& hints)
+{
+    std::array<size_t, static_cast<size_t>(RegionClass::Count)> rank;
+    rank.fill(SIZE_MAX);
+    for (size_t i = 0; i < hints.classes.size(); ++i) {
+        size_t& slot = rank[static_cast<size_t>(hints.classes[i])];
+        slot = std::min(slot, i);
+    }
+
+    std::vector<std::pair<size_t, MemoryRegion>> ranked;
+    ranked.reserve(regions.size());
+    for (const MemoryRegion& region : regions) {
+        const size_t regionRank = rank[static_cast<size_t>(classify(region))];
+        if (regionRank == SIZE_MAX || !region.isReadable() || region.size < hints.minSize ||
+            (hints.maxSize != 0 && region.size > hints.maxSize)) {
+            continue;
+        }
+        ranked.emplace_back(regionRank, region);
+    }
+
+    // Stable, so regions of one class stay in address order
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<MemoryRegion> prioritized;
+    prioritized.reserve(ranked.size());
+    for (const auto& entry : ranked) {
+        prioritized.push_back(entry.second);
+    }
+    return prioritized;
+}
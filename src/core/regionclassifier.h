@@ -0,0 +1,65 @@
+#ifndef REGIONCLASSIFIER_H
+#define REGIONCLASSIFIER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "../platform/processmemory.h"
+
+// What a region is likely to hold, from its type, protection and size
+enum class RegionClass : uint8_t {
+    // Private and writable: allocator and garbage-collected heap blocks
+    Heap,
+    // Private and executable: JIT output
+    PrivateCode,
+    // Writable sections of the executable and its DLLs
+    ImageData,
+    // Code sections of the executable and its DLLs
+    ImageCode,
+    // File and section mappings
+    Mapped,
+    // Mappings above Constants::SCAN_LARGE_MAPPING_SIZE, mostly GPU staging
+    LargeMapped,
+    Count
+};
+
+// Which regions a build's flag can live in. Set per build in config.json,
+// see ConfigManager::parseRegionHints
+struct RegionHints {
+    // Classes to scan, most likely first; the others are skipped
+    std::vector<RegionClass> classes = {
+        RegionClass::Heap, RegionClass::ImageData, RegionClass::Mapped, RegionClass::PrivateCode
+    };
+    uint64_t minSize = 0;
+    // 0 for no limit
+    uint64_t maxSize = 0;
+
+    bool operator==(const RegionHints& other) const {
+        return classes == other.classes && minSize == other.minSize && maxSize == other.maxSize;
+    }
+    bool operator!=(const RegionHints& other) const { return !(*this == other); }
+};
+
+class RegionClassifier
+{
+public:
+    static RegionClass classify(const MemoryRegion& region);
+
+    // Names used by config.json, e.g. "heap" or "image_data"
+    static const char* className(RegionClass regionClass);
+    static bool parseClassName(const std::string& name, RegionClass& regionClass);
+
+    // Everything either would scan, in a's order and then b's, so a scan
+    // for several builds at once misses none of them
+    static RegionHints combine(const RegionHints& a, const RegionHints& b);
+
+    // The regions hints allows, most likely class first and in address
+    // order within a class. Work items keep this order in the scheduler
+    static std::vector<MemoryRegion> prioritize(const std::vector<MemoryRegion>& regions, const RegionHints& hints);
+};
+
+#endif // REGIONCLASSIFIER_H
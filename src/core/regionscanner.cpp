@@ -0,0 +1,244 @@
+#include "regionscanner.h"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Project includes
+#include "pipelinedreader.h"
+#include "streamsearcher.h"
+#include "../utils/resourceusage.h"
+
+RegionScanner::RegionScanner(const IProcessMemory& process, const RegionScanOptions& options, ScanBufferPool* buffers,
+                             ScanThreadPool* threads)
+    : m_process(process)
+    , m_options(options)
+    , m_ownedBuffers(buffers ? nullptr : std::make_unique<ScanBufferPool>())
+    , m_ownedThreads(threads ? nullptr : std::make_unique<ScanThreadPool>())
+    , m_buffers(buffers ? buffers : m_ownedBuffers.get())
+    , m_threads(threads ? threads : m_ownedThreads.get())
+{
+}
+
+bool RegionScanner::scan(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+                         const CancellationToken& token, RegionMatch& result)
+{
+    result = {0, 0, false};
+    m_stats = RegionScanStats();
+
+    if (!matcher.isValid()) {
+        return false;
+    }
+
+    std::vector<ScanRange> ranges;
+    ranges.reserve(regions.size());
+    for (const MemoryRegion& region : regions) {
+        ranges.push_back({region.base, region.size});
+    }
+
+    std::vector<ScanWorkItem> items = ScanScheduler::splitRanges(ranges, m_options.itemSize,
+        matcher.getMaxPatternSize() - 1);
+    m_stats.itemCount = items.size();
+
+    ScanScheduler scheduler(m_options.workerCount, m_threads);
+    std::vector<ScanBufferPool::Lease> buffers(scheduler.getWorkerCount());
+    std::vector<std::unique_ptr<PipelinedReader>> readers(scheduler.getWorkerCount());
+    const bool pipelined = m_options.pipelineDepth >= 2;
+    std::mutex resultMutex;
+    std::atomic<uint64_t> bytesFinished(0);
+
+    const uint64_t syscallsBefore = m_process.getSyscallCount();
+    const ResourceUsage usageBefore = ResourceUsage::current();
+    const ScanBufferPoolStats poolBefore = m_buffers->getStats();
+    const size_t threadsBefore = m_threads->getThreadCount();
+
+    bool found = scheduler.run(items,
+        [&](const ScanWorkItem& item, int workerId, const CancellationToken& itemToken) {
+            RegionMatch itemResult = {0, 0, false};
+            bool itemFound = false;
+
+            if (pipelined) {
+                std::unique_ptr<PipelinedReader>& reader = readers[workerId];
+                if (!reader) {
+                    reader = std::make_unique<PipelinedReader>(m_process, m_options.chunkSize, m_options.pipelineDepth,
+                                                               *m_buffers, *m_threads);
+                }
+            }
+
+            if (pipelined && readers[workerId]->isValid()) {
+                itemFound = scanItemPipelined(item, matcher, *readers[workerId], itemToken, itemResult);
+            } else {
+                itemFound = scanItem(item, matcher, buffers[workerId], itemToken, itemResult);
+            }
+
+            if (!itemFound) {
+                bytesFinished.fetch_add(item.size, std::memory_order_relaxed);
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (!result.found) {
+                result = itemResult;
+                m_stats.bytesBeforeHit = bytesFinished.load(std::memory_order_relaxed) +
+                                         (itemResult.address - item.address);
+            }
+            return true;
+        },
+        token);
+
+    m_stats.workers = scheduler.getWorkerStats();
+    for (const ScanWorkerStats& stats : m_stats.workers) {
+        m_stats.bytesScanned += stats.bytes;
+    }
+    for (const std::unique_ptr<PipelinedReader>& reader : readers) {
+        m_stats.stalls += reader ? reader->getStalls() : 0;
+    }
+    m_stats.syscalls = m_process.getSyscallCount() - syscallsBefore;
+
+    // Leases go back before the pool is read, so its sizes are final
+    buffers.clear();
+    readers.clear();
+    const ResourceUsage usageAfter = ResourceUsage::current();
+    m_stats.pageFaults = usageAfter.pageFaults - usageBefore.pageFaults;
+    m_stats.peakRss = usageAfter.peakRss;
+    m_stats.buffers = m_buffers->getStats();
+    m_stats.buffers.allocations -= poolBefore.allocations;
+    m_stats.buffers.reuses -= poolBefore.reuses;
+    m_stats.threadsStarted = m_threads->getThreadCount() - threadsBefore;
+
+    return found && result.found;
+}
+
+bool RegionScanner::isScannable(const MemoryRegion& region)
+{
+    return region.isReadable() && (region.protection & (MemoryProtection::WRITE | MemoryProtection::EXECUTE));
+}
+
+std::vector<MemoryRegion> RegionScanner::scannableRegions(const std::vector<MemoryRegion>& regions)
+{
+    std::vector<MemoryRegion> scannable;
+    for (const MemoryRegion& region : regions) {
+        if (isScannable(region)) {
+            scannable.push_back(region);
+        }
+    }
+    return scannable;
+}
+
+bool RegionScanner::scanItem(const ScanWorkItem& item, const MultiPatternMatcher& matcher, ScanBufferPool::Lease& buffer,
+                             const CancellationToken& token, RegionMatch& result) const
+{
+    // Snapshot-backed items are searched where they lie
+    if (const uint8_t* data = m_process.view(item.address, item.size)) {
+        return searchChunks(data, item, matcher, token, result);
+    }
+
+    if (buffer.size() < item.size) {
+        buffer = m_buffers->acquire(item.size);
+        if (!buffer.isValid()) {
+            return false;
+        }
+    }
+
+    // The whole item is fetched as one batch of chunk-sized spans, so an
+    // unreadable page only costs the span it falls in
+    std::vector<ReadSpan> spans;
+    spans.reserve(item.size / m_options.chunkSize + 1);
+    for (size_t offset = 0; offset < item.size; offset += m_options.chunkSize) {
+        size_t chunkSize = std::min(m_options.chunkSize, item.size - offset);
+        spans.push_back({item.address + offset, chunkSize, buffer.data() + offset, 0});
+    }
+
+    const size_t spansRead = m_process.readBatch(spans.data(), spans.size());
+    if (token.isCancelled()) {
+        return false;
+    }
+
+    if (spansRead == spans.size()) {
+        return searchChunks(buffer.data(), item, matcher, token, result);
+    }
+
+    StreamSearcher<MultiPatternMatcher> stream(matcher);
+    stream.reset(item.address);
+
+    for (const ReadSpan& span : spans) {
+        if (token.isCancelled()) {
+            break;
+        }
+
+        if (span.bytesRead > 0) {
+            StreamMatch match = stream.feed(static_cast<const uint8_t*>(span.destination), span.bytesRead);
+            if (match.found()) {
+                result = {static_cast<uintptr_t>(match.position), match.patternIndex, true};
+                return true;
+            }
+        }
+
+        // A short or failed read leaves a gap, so nothing carries over it
+        if (span.bytesRead != span.size) {
+            stream.reset(span.address + span.size);
+        }
+    }
+
+    return false;
+}
+
+// Searches an item that is already in memory one chunk at a time, checking
+// the token in between. Each search runs on into the next chunk by the
+// longest pattern less one byte, so a match straddling two chunks is found
+// in the first and the leftmost match is still the one reported
+bool RegionScanner::searchChunks(const uint8_t* data, const ScanWorkItem& item, const MultiPatternMatcher& matcher,
+                                 const CancellationToken& token, RegionMatch& result) const
+{
+    const size_t overlap = matcher.getMaxPatternSize() > 0 ? matcher.getMaxPatternSize() - 1 : 0;
+
+    for (size_t offset = 0; offset < item.size; offset += m_options.chunkSize) {
+        if (token.isCancelled()) {
+            return false;
+        }
+
+        const size_t size = std::min(m_options.chunkSize + overlap, item.size - offset);
+        MultiPatternMatcher::Match match = matcher.search(data + offset, size);
+        if (match.found()) {
+            result = {item.address + offset + match.offset, match.patternIndex, true};
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RegionScanner::scanItemPipelined(const ScanWorkItem& item, const MultiPatternMatcher& matcher,
+                                      PipelinedReader& reader, const CancellationToken& token,
+                                      RegionMatch& result) const
+{
+    if (const uint8_t* data = m_process.view(item.address, item.size)) {
+        return searchChunks(data, item, matcher, token, result);
+    }
+
+    StreamSearcher<MultiPatternMatcher> stream(matcher);
+    stream.reset(item.address);
+    reader.start(item.address, item.size);
+
+    PipelineChunk chunk;
+    while (!token.isCancelled() && reader.next(chunk)) {
+        if (chunk.bytesRead > 0) {
+            StreamMatch match = stream.feed(chunk.data, chunk.bytesRead);
+            if (match.found()) {
+                reader.cancel();
+                result = {static_cast<uintptr_t>(match.position), match.patternIndex, true};
+                return true;
+            }
+        }
+
+        // A short or failed read leaves a gap, so nothing carries over it
+        if (chunk.bytesRead != chunk.size) {
+            stream.reset(chunk.address + chunk.size);
+        }
+    }
+
+    reader.cancel();
+    return false;
+}
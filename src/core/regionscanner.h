@@ -0,0 +1,98 @@
+#ifndef REGIONSCANNER_H
+#define REGIONSCANNER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Project includes
+#include "cancellationtoken.h"
+#include "multipatternmatcher.h"
+#include "scanbufferpool.h"
+#include "scanscheduler.h"
+#include "scanthreadpool.h"
+#include "../platform/processmemory.h"
+#include "../utils/constants.h"
+
+class PipelinedReader;
+
+struct RegionMatch {
+    uintptr_t address;
+    size_t patternIndex;
+    bool found;
+};
+
+struct RegionScanOptions {
+    size_t itemSize = Constants::SCAN_WORK_ITEM_SIZE;
+    size_t chunkSize = Constants::MEMORY_CHUNK_SIZE;
+    // Below 2 each item is read in one batch and then searched
+    size_t pipelineDepth = Constants::SCAN_PIPELINE_DEPTH;
+    // 0 picks one worker per hardware thread
+    unsigned workerCount = 0;
+};
+
+struct RegionScanStats {
+    size_t itemCount = 0;
+    uint64_t bytesScanned = 0;
+    uint64_t syscalls = 0;
+    uint64_t stalls = 0;
+    // Bytes of the items finished before the match plus its offset in its
+    // own item; how well the region order guessed
+    uint64_t bytesBeforeHit = 0;
+    // Of this whole process, while the scan ran and highest so far
+    uint64_t pageFaults = 0;
+    uint64_t peakRss = 0;
+    // Allocations and reuses during the scan, sizes after it
+    ScanBufferPoolStats buffers;
+    // Threads the thread pool had to add; none once it is warm
+    uint64_t threadsStarted = 0;
+    std::vector<ScanWorkerStats> workers;
+};
+
+// Searches a set of regions of one process for the first match of any
+// pattern. Regions are cut into work items for a ScanScheduler; each item
+// is searched in place when the backend can map it, otherwise it is read
+// through a PipelinedReader or in one readBatch call. Buffers and threads
+// come from pools the caller can keep across scans. Free of Qt so the GUI,
+// the benchmarks and the command line share one scan path
+class RegionScanner
+{
+public:
+    // Without pools the scanner keeps its own, which live as long as it
+    explicit RegionScanner(const IProcessMemory& process, const RegionScanOptions& options = RegionScanOptions(),
+                           ScanBufferPool* buffers = nullptr, ScanThreadPool* threads = nullptr);
+
+    // Blocks until a match is found, every item was searched or token is
+    // cancelled, which is checked between chunks
+    bool scan(const std::vector<MemoryRegion>& regions, const MultiPatternMatcher& matcher,
+              const CancellationToken& token, RegionMatch& result);
+
+    // Of the last scan()
+    const RegionScanStats& getStats() const { return m_stats; }
+
+    // Writable or executable committed regions; read-only data never holds
+    // the autoplay flag
+    static bool isScannable(const MemoryRegion& region);
+    static std::vector<MemoryRegion> scannableRegions(const std::vector<MemoryRegion>& regions);
+    const RegionScanOptions& getOptions() const { return m_options; }
+
+private:
+    bool scanItem(const ScanWorkItem& item, const MultiPatternMatcher& matcher, ScanBufferPool::Lease& buffer,
+                  const CancellationToken& token, RegionMatch& result) const;
+    bool scanItemPipelined(const ScanWorkItem& item, const MultiPatternMatcher& matcher, PipelinedReader& reader,
+                           const CancellationToken& token, RegionMatch& result) const;
+    bool searchChunks(const uint8_t* data, const ScanWorkItem& item, const MultiPatternMatcher& matcher,
+                      const CancellationToken& token, RegionMatch& result) const;
+
+    const IProcessMemory& m_process;
+    RegionScanOptions m_options;
+    std::unique_ptr<ScanBufferPool> m_ownedBuffers;
+    std::unique_ptr<ScanThreadPool> m_ownedThreads;
+    ScanBufferPool* m_buffers;
+    ScanThreadPool* m_threads;
+    RegionScanStats m_stats;
+};
+
+#endif // REGIONSCANNER_H
@@ -0,0 +1,95 @@
+#include "regiontracker.h"
+
+// STL includes
+#include <algorithm>
+#include <array>
+
+// Project includes
+#include "../utils/constants.h"
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace
+
+std::vector<MemoryRegion> RegionTracker::update(const IProcessMemory& process, const std::vector<MemoryRegion>& current,
+                                                RegionDiffStats* stats)
+{
+    RegionDiffStats diff;
+    std::vector<MemoryRegion> changed;
+    std::vector<TrackedRegion> tracked;
+    tracked.reserve(current.size());
+
+    for (const MemoryRegion& region : current) {
+        const uint64_t hash = sampleHash(process, region);
+        tracked.push_back({region.base, region.size, region.protection, hash});
+
+        auto previous = std::lower_bound(m_regions.begin(), m_regions.end(), region.base,
+            [](const TrackedRegion& entry, uintptr_t base) { return entry.base < base; });
+
+        if (previous == m_regions.end() || previous->base != region.base) {
+            ++diff.added;
+        } else if (previous->size < region.size) {
+            ++diff.grown;
+        } else if (previous->size != region.size || previous->protection != region.protection ||
+                   previous->hash != hash) {
+            ++diff.changed;
+        } else {
+            ++diff.unchanged;
+            continue;
+        }
+
+        changed.push_back(region);
+        diff.bytes += region.size;
+    }
+
+    diff.removed = m_regions.size() + diff.added - current.size();
+
+    std::sort(tracked.begin(), tracked.end(), [](const TrackedRegion& a, const TrackedRegion& b) { return a.base < b.base; });
+    m_regions = std::move(tracked);
+
+    if (stats) {
+        *stats = diff;
+    }
+    return changed;
+}
+
+uint64_t RegionTracker::sampleHash(const IProcessMemory& process, const MemoryRegion& region)
+{
+    constexpr size_t SAMPLES = Constants::REGION_HASH_SAMPLES;
+    constexpr size_t SAMPLE_SIZE = Constants::REGION_HASH_SAMPLE_SIZE;
+
+    std::array<uint8_t, SAMPLES * SAMPLE_SIZE> buffer;
+    std::array<ReadSpan, SAMPLES> spans;
+    size_t count = 0;
+
+    if (region.size <= buffer.size()) {
+        spans[count++] = {region.base, region.size, buffer.data(), 0};
+    } else {
+        const size_t stride = (region.size - SAMPLE_SIZE) / (SAMPLES - 1);
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            spans[count++] = {region.base + i * stride, SAMPLE_SIZE, buffer.data() + i * SAMPLE_SIZE, 0};
+        }
+    }
+
+    process.readBatch(spans.data(), count);
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t bytesRead = spans[i].bytesRead;
+        hash = fnv1a(hash, reinterpret_cast<const uint8_t*>(&bytesRead), sizeof(bytesRead));
+        hash = fnv1a(hash, static_cast<const uint8_t*>(spans[i].destination), spans[i].bytesRead);
+    }
+    return hash;
+}
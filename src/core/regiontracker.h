@@ -0,0 +1,56 @@
+#ifndef REGIONTRACKER_H
+#define REGIONTRACKER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Project includes
+#include "../platform/processmemory.h"
+
+struct RegionDiffStats {
+    size_t added = 0;
+    size_t grown = 0;
+    size_t changed = 0;
+    size_t unchanged = 0;
+    size_t removed = 0;
+    // Of the regions returned for searching
+    uint64_t bytes = 0;
+};
+
+// Remembers the regions a scan searched without a match, so the next
+// attempt only searches regions that are new, grew, changed protection or
+// whose content changed. Content is compared through a hash of a few
+// sampled spans per region, so a write that lands between the samples
+// goes unseen; callers fall back to a full scan now and then
+class RegionTracker
+{
+public:
+    // Returns the regions of current that need searching, in their given
+    // order, and remembers all of current. The caller must search every
+    // returned region, or reset() if that search is cut short. With
+    // nothing remembered every region is returned
+    std::vector<MemoryRegion> update(const IProcessMemory& process, const std::vector<MemoryRegion>& current,
+                                     RegionDiffStats* stats = nullptr);
+
+    void reset() { m_regions.clear(); }
+    bool isEmpty() const { return m_regions.empty(); }
+
+    // FNV-1a over Constants::REGION_HASH_SAMPLES spans spread evenly over
+    // the region, including how much of each could be read
+    static uint64_t sampleHash(const IProcessMemory& process, const MemoryRegion& region);
+
+private:
+    struct TrackedRegion {
+        uintptr_t base;
+        size_t size;
+        uint32_t protection;
+        uint64_t hash;
+    };
+
+    // Sorted by base, as enumerateRegions() returns them
+    std::vector<TrackedRegion> m_regions;
+};
+
+#endif // REGIONTRACKER_H
@@ -0,0 +1,262 @@
+#include "scanbufferpool.h"
+
+// System includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+size_t roundUp(size_t size, size_t granularity)
+{
+    return (size + granularity - 1) / granularity * granularity;
+}
+
+#ifdef _WIN32
+
+// Large pages need SeLockMemoryPrivilege enabled on the process token;
+// accounts without it get normal pages
+bool enableLockMemoryPrivilege()
+{
+    static const bool enabled = []() {
+        HANDLE token = nullptr;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            return false;
+        }
+
+        TOKEN_PRIVILEGES privileges = {};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        bool ok = LookupPrivilegeValueW(nullptr, L"SeLockMemoryPrivilege", &privileges.Privileges[0].Luid) &&
+                  AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                  GetLastError() == ERROR_SUCCESS;
+        CloseHandle(token);
+        return ok;
+    }();
+    return enabled;
+}
+
+#endif
+
+} // namespace
+
+ScanBuffer::ScanBuffer(ScanBuffer&& other) noexcept
+    : m_data(other.m_data)
+    , m_size(other.m_size)
+    , m_mapping(other.m_mapping)
+    , m_mappingSize(other.m_mappingSize)
+    , m_largePages(other.m_largePages)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_mapping = nullptr;
+    other.m_mappingSize = 0;
+    other.m_largePages = false;
+}
+
+ScanBuffer& ScanBuffer::operator=(ScanBuffer&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_mapping = other.m_mapping;
+        m_mappingSize = other.m_mappingSize;
+        m_largePages = other.m_largePages;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_mapping = nullptr;
+        other.m_mappingSize = 0;
+        other.m_largePages = false;
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+ScanBuffer ScanBuffer::allocate(size_t size, bool largePages)
+{
+    ScanBuffer buffer;
+    if (size == 0) {
+        return buffer;
+    }
+
+    const size_t largePageSize = GetLargePageMinimum();
+    if (largePages && largePageSize > 0 && size >= largePageSize && enableLockMemoryPrivilege()) {
+        const size_t rounded = roundUp(size, largePageSize);
+        void* mapping = VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (mapping) {
+            buffer.m_mapping = mapping;
+            buffer.m_mappingSize = rounded;
+            buffer.m_largePages = true;
+        }
+    }
+
+    if (!buffer.m_mapping) {
+        buffer.m_mapping = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        buffer.m_mappingSize = size;
+    }
+    if (!buffer.m_mapping) {
+        return ScanBuffer();
+    }
+
+    buffer.m_data = static_cast<uint8_t*>(buffer.m_mapping);
+    buffer.m_size = buffer.m_mappingSize;
+    return buffer;
+}
+
+void ScanBuffer::release()
+{
+    if (m_mapping) {
+        VirtualFree(m_mapping, 0, MEM_RELEASE);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_largePages = false;
+}
+
+#else
+
+ScanBuffer ScanBuffer::allocate(size_t size, bool largePages)
+{
+    ScanBuffer buffer;
+    if (size == 0) {
+        return buffer;
+    }
+
+    constexpr size_t HUGEPAGE_SIZE = Constants::SCAN_BUFFER_HUGEPAGE_SIZE;
+    const size_t rounded = roundUp(size, 4096);
+    largePages = largePages && size >= HUGEPAGE_SIZE;
+
+    // Hugepages only back aligned ranges, so the mapping is padded by one
+    // hugepage and starts at the first boundary inside it
+    const size_t mappingSize = largePages ? rounded + HUGEPAGE_SIZE : rounded;
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return buffer;
+    }
+
+    buffer.m_mapping = mapping;
+    buffer.m_mappingSize = mappingSize;
+    buffer.m_data = static_cast<uint8_t*>(mapping);
+    buffer.m_size = rounded;
+
+#ifdef MADV_HUGEPAGE
+    // Only whole hugepages are advised; a partial tail would fault in
+    // memory the buffer never uses
+    if (largePages) {
+        buffer.m_data = reinterpret_cast<uint8_t*>(roundUp(reinterpret_cast<uintptr_t>(mapping), HUGEPAGE_SIZE));
+        buffer.m_largePages = madvise(buffer.m_data, rounded / HUGEPAGE_SIZE * HUGEPAGE_SIZE, MADV_HUGEPAGE) == 0;
+    }
+#endif
+
+    return buffer;
+}
+
+void ScanBuffer::release()
+{
+    if (m_mapping) {
+        munmap(m_mapping, m_mappingSize);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_largePages = false;
+}
+
+#endif
+
+ScanBufferPool::Lease::Lease(Lease&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_buffer(std::move(other.m_buffer))
+{
+    other.m_pool = nullptr;
+}
+
+ScanBufferPool::Lease& ScanBufferPool::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        m_pool = other.m_pool;
+        m_buffer = std::move(other.m_buffer);
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+void ScanBufferPool::Lease::reset()
+{
+    if (m_pool && m_buffer.data()) {
+        m_pool->giveBack(std::move(m_buffer));
+    }
+    m_pool = nullptr;
+    m_buffer = ScanBuffer();
+}
+
+ScanBufferPool::ScanBufferPool(bool largePages)
+    : m_largePages(largePages)
+{
+}
+
+ScanBufferPool::Lease ScanBufferPool::acquire(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto best = m_idle.end();
+        for (auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+            if (it->size() >= size && (best == m_idle.end() || it->size() < best->size())) {
+                best = it;
+            }
+        }
+
+        if (best != m_idle.end()) {
+            ScanBuffer buffer = std::move(*best);
+            m_idle.erase(best);
+            ++m_stats.reuses;
+            return Lease(this, std::move(buffer));
+        }
+    }
+
+    // Mapping can take a while, so it happens outside the lock
+    ScanBuffer buffer = ScanBuffer::allocate(size, m_largePages);
+    if (!buffer.data()) {
+        return Lease();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.allocations;
+    m_stats.largePageBuffers += buffer.isLargePages() ? 1 : 0;
+    m_stats.bytesHeld += buffer.size();
+    return Lease(this, std::move(buffer));
+}
+
+void ScanBufferPool::trim()
+{
+    std::vector<ScanBuffer> idle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        idle.swap(m_idle);
+        for (const ScanBuffer& buffer : idle) {
+            m_stats.bytesHeld -= buffer.size();
+            m_stats.largePageBuffers -= buffer.isLargePages() ? 1 : 0;
+        }
+    }
+}
+
+ScanBufferPoolStats ScanBufferPool::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ScanBufferPool::giveBack(ScanBuffer buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(std::move(buffer));
+}
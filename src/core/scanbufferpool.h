@@ -0,0 +1,113 @@
+#ifndef SCANBUFFERPOOL_H
+#define SCANBUFFERPOOL_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Project includes
+#include "../utils/constants.h"
+
+// Block of memory straight from the OS: page aligned, so any SIMD load is
+// aligned, and never value-initialized. With large pages the block is
+// backed by transparent hugepages on Linux, or by large pages on Windows
+// when the account holds the lock-memory privilege, falling back to
+// normal pages otherwise
+class ScanBuffer
+{
+public:
+    ScanBuffer() = default;
+    ~ScanBuffer() { release(); }
+
+    ScanBuffer(ScanBuffer&& other) noexcept;
+    ScanBuffer& operator=(ScanBuffer&& other) noexcept;
+
+    ScanBuffer(const ScanBuffer&) = delete;
+    ScanBuffer& operator=(const ScanBuffer&) = delete;
+
+    // Empty on failure
+    static ScanBuffer allocate(size_t size, bool largePages);
+
+    uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isLargePages() const { return m_largePages; }
+
+private:
+    void release();
+
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    // What was mapped, which the data may sit inside of
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    bool m_largePages = false;
+};
+
+struct ScanBufferPoolStats {
+    uint64_t allocations = 0;
+    uint64_t reuses = 0;
+    uint64_t largePageBuffers = 0;
+    // Held by the pool, idle or leased
+    uint64_t bytesHeld = 0;
+};
+
+// Scan buffers kept from one scan to the next, so a retry or a watch pass
+// doesn't map and fault in fresh memory on every worker. Leases go back to
+// the pool when destroyed and must not outlive it. Thread-safe
+class ScanBufferPool
+{
+public:
+    class Lease
+    {
+    public:
+        Lease() = default;
+        ~Lease() { reset(); }
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        uint8_t* data() const { return m_buffer.data(); }
+        size_t size() const { return m_buffer.size(); }
+        bool isValid() const { return m_buffer.data() != nullptr; }
+
+        // Hands the buffer back early
+        void reset();
+
+    private:
+        friend class ScanBufferPool;
+        Lease(ScanBufferPool* pool, ScanBuffer buffer) : m_pool(pool), m_buffer(std::move(buffer)) {}
+
+        ScanBufferPool* m_pool = nullptr;
+        ScanBuffer m_buffer;
+    };
+
+    explicit ScanBufferPool(bool largePages = Constants::SCAN_BUFFER_LARGE_PAGES);
+
+    ScanBufferPool(const ScanBufferPool&) = delete;
+    ScanBufferPool& operator=(const ScanBufferPool&) = delete;
+
+    // The smallest idle buffer of at least size bytes, or a new one. The
+    // lease is invalid when the OS refuses the memory
+    Lease acquire(size_t size);
+
+    // Frees the idle buffers
+    void trim();
+
+    ScanBufferPoolStats getStats() const;
+
+private:
+    void giveBack(ScanBuffer buffer);
+
+    const bool m_largePages;
+    mutable std::mutex m_mutex;
+    std::vector<ScanBuffer> m_idle;
+    ScanBufferPoolStats m_stats;
+};
+
+#endif // SCANBUFFERPOOL_H
@@ -0,0 +1,154 @@
+#include "scanscheduler.h"
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Project includes
+#include "scanthreadpool.h"
+#include "../utils/constants.h"
+
+namespace {
+
+struct WorkQueue {
+    std::mutex mutex;
+    std::deque<size_t> items;
+
+    bool popFront(size_t& item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        return true;
+    }
+
+    bool stealBack(size_t& item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.back();
+        items.pop_back();
+        return true;
+    }
+};
+
+} // namespace
+
+ScanScheduler::ScanScheduler(unsigned workerCount, ScanThreadPool* pool)
+    : m_workerCount(workerCount)
+    , m_pool(pool)
+{
+    if (m_workerCount == 0) {
+        m_workerCount = std::thread::hardware_concurrency();
+    }
+    if (m_workerCount == 0) {
+        m_workerCount = Constants::NUM_SEARCH_THREADS;
+    }
+}
+
+std::vector<ScanWorkItem> ScanScheduler::splitRanges(const std::vector<ScanRange>& ranges, size_t itemSize, size_t overlap)
+{
+    std::vector<ScanWorkItem> items;
+
+    for (size_t index = 0; index < ranges.size(); ++index) {
+        const ScanRange& range = ranges[index];
+        for (size_t offset = 0; offset < range.size; offset += itemSize) {
+            size_t size = std::min(range.size - offset, itemSize + overlap);
+            items.push_back({range.base + offset, size, index});
+        }
+    }
+    return items;
+}
+
+bool ScanScheduler::run(const std::vector<ScanWorkItem>& items, const WorkFunction& work, const CancellationToken& token)
+{
+    m_stats.assign(m_workerCount, ScanWorkerStats{0, 0.0, 0, 0, 0});
+
+    if (items.empty()) {
+        return false;
+    }
+
+    const unsigned workerCount = static_cast<unsigned>(std::min<size_t>(m_workerCount, items.size()));
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    queues.reserve(workerCount);
+
+    // Items are dealt out in turn, so together the workers follow the
+    // caller's order and the likeliest items are searched first; thieves
+    // take from the back, where the least likely ones wait
+    for (unsigned w = 0; w < workerCount; ++w) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        queues[i % workerCount]->items.push_back(i);
+    }
+
+    std::atomic<bool> found(false);
+    const CancellationToken scanToken = token.child();
+
+    auto workerLoop = [&](unsigned id) {
+        auto started = std::chrono::steady_clock::now();
+        ScanWorkerStats& stats = m_stats[id];
+        stats.workerId = static_cast<int>(id);
+
+        while (!scanToken.isCancelled()) {
+            size_t index = 0;
+            bool haveItem = queues[id]->popFront(index);
+
+            for (unsigned k = 1; !haveItem && k < workerCount; ++k) {
+                haveItem = queues[(id + k) % workerCount]->stealBack(index);
+                if (haveItem) {
+                    ++stats.steals;
+                }
+            }
+
+            if (!haveItem) {
+                break;
+            }
+
+            const ScanWorkItem& item = items[index];
+            ++stats.items;
+            stats.bytes += item.size;
+
+            if (work(item, static_cast<int>(id), scanToken)) {
+                found = true;
+                scanToken.cancel();
+            }
+        }
+
+        stats.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    };
+
+    std::unique_ptr<ScanThreadPool> ownedPool;
+    ScanThreadPool* pool = m_pool;
+    if (!pool) {
+        ownedPool = std::make_unique<ScanThreadPool>();
+        pool = ownedPool.get();
+    }
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(workerCount - 1);
+    for (unsigned w = 1; w < workerCount; ++w) {
+        workers.push_back(pool->submit([&workerLoop, w]() { workerLoop(w); }));
+    }
+
+    // The calling thread works as worker 0
+    workerLoop(0);
+
+    for (std::future<void>& worker : workers) {
+        worker.wait();
+    }
+
+    m_stats.resize(workerCount);
+    return found;
+}
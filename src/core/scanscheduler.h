@@ -0,0 +1,69 @@
+#ifndef SCANSCHEDULER_H
+#define SCANSCHEDULER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Project includes
+#include "cancellationtoken.h"
+
+class ScanThreadPool;
+
+struct ScanRange {
+    uintptr_t base;
+    size_t size;
+};
+
+struct ScanWorkItem {
+    uintptr_t address;
+    size_t size;
+    size_t regionIndex;
+};
+
+struct ScanWorkerStats {
+    int workerId;
+    double wallMs;
+    uint64_t items;
+    uint64_t bytes;
+    uint64_t steals;
+};
+
+// Runs scan work items on a pool of worker threads. Items are dealt to the
+// workers in the order given, and a worker steals from the back of another
+// worker's queue once its own runs dry, so a few large heap regions can't
+// leave the other threads idle. The first item reporting a match cancels
+// everything still queued and, through the token work gets, the items
+// other workers are in the middle of. Workers other than the calling
+// thread run on a ScanThreadPool
+class ScanScheduler
+{
+public:
+    // Returns true when the item produced a match. token is cancelled once
+    // the scan should end, and work checks it between chunks
+    using WorkFunction = std::function<bool(const ScanWorkItem& item, int workerId, const CancellationToken& token)>;
+
+    // Without a pool each run() starts and joins its own threads
+    explicit ScanScheduler(unsigned workerCount = 0, ScanThreadPool* pool = nullptr);
+
+    // Blocks until all items ran, one reported a match or token was
+    // cancelled; returns true if some item reported a match
+    bool run(const std::vector<ScanWorkItem>& items, const WorkFunction& work, const CancellationToken& token);
+
+    unsigned getWorkerCount() const { return m_workerCount; }
+    const std::vector<ScanWorkerStats>& getWorkerStats() const { return m_stats; }
+
+    // Cuts ranges into items of at most itemSize bytes. Each item reads
+    // overlap extra bytes past its end (clamped to its range) so matches
+    // starting near the cut are still complete inside one item
+    static std::vector<ScanWorkItem> splitRanges(const std::vector<ScanRange>& ranges, size_t itemSize, size_t overlap);
+
+private:
+    unsigned m_workerCount;
+    ScanThreadPool* m_pool;
+    std::vector<ScanWorkerStats> m_stats;
+};
+
+#endif // SCANSCHEDULER_H
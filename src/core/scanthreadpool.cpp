@@ -0,0 +1,60 @@
+#include "scanthreadpool.h"
+
+ScanThreadPool::~ScanThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+std::future<void> ScanThreadPool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> future = packaged.get_future();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(std::move(packaged));
+
+    // Every queued task needs a thread of its own to be free, otherwise a
+    // task waiting on a later one would wait forever
+    if (m_idle >= m_tasks.size()) {
+        m_wake.notify_one();
+    } else {
+        m_threads.emplace_back(&ScanThreadPool::threadLoop, this);
+    }
+    return future;
+}
+
+size_t ScanThreadPool::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_threads.size();
+}
+
+void ScanThreadPool::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        ++m_idle;
+        m_wake.wait(lock, [this]() { return m_quit || !m_tasks.empty(); });
+        --m_idle;
+
+        if (m_tasks.empty()) {
+            return;
+        }
+
+        std::packaged_task<void()> task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef SCANTHREADPOOL_H
+#define SCANTHREADPOOL_H
+
+// STL includes
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Long-lived threads for scan workers, pipelined readers and the scan and
+// autoplay loops themselves. A task runs on an idle thread when there is
+// one and on a new thread otherwise, so tasks that wait on each other
+// (a worker on its reader) can never starve; the threads stay for the
+// next task, and once warm a scan starts without creating any. Joined on
+// destruction, after the queued tasks ran
+class ScanThreadPool
+{
+public:
+    ScanThreadPool() = default;
+    ~ScanThreadPool();
+
+    ScanThreadPool(const ScanThreadPool&) = delete;
+    ScanThreadPool& operator=(const ScanThreadPool&) = delete;
+
+    // The future becomes ready once task has returned
+    std::future<void> submit(std::function<void()> task);
+
+    // Threads started so far; none ever exit before the pool does
+    size_t getThreadCount() const;
+
+private:
+    void threadLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::packaged_task<void()>> m_tasks;
+    std::vector<std::thread> m_threads;
+    size_t m_idle = 0;
+    bool m_quit = false;
+};
+
+#endif // SCANTHREADPOOL_H
@@ -0,0 +1,36 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// STL includes
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BBA_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// Lets a single function use a newer instruction set than the rest of the
+// build; callers must check PatternMatcher::activeKernel() first
+#if defined(__GNUC__) || defined(__clang__)
+#define BBA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BBA_TARGET(isa)
+#endif
+
+namespace Simd {
+    inline unsigned countTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+}
+
+#endif // SIMD_H
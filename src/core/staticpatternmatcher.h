@@ -0,0 +1,90 @@
+#ifndef STATICPATTERNMATCHER_H
+#define STATICPATTERNMATCHER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// Names the patterns known at build time; see GenerateSignatures.cmake
+template <typename... Patterns>
+struct SignatureList {};
+
+// Full compare for a pattern fixed at compile time. Pattern::BYTES is a
+// constexpr std::array of byte values with -1 for a wildcard. The pattern
+// is cut into 8-byte words whose masks and values are constants, so the
+// compare unrolls into one load and one test per word: words that are all
+// wildcards disappear and words without wildcards skip the mask. Assumes a
+// little-endian target, as the rest of the scanner does
+template <typename Pattern>
+class StaticPatternMatcher
+{
+public:
+    static constexpr size_t SIZE = Pattern::BYTES.size();
+    static_assert(SIZE > 0, "Signature must not be empty");
+
+    // data must hold SIZE bytes
+    static bool matchesAt(const uint8_t* data)
+    {
+        return compareWords(data, std::make_index_sequence<WORD_COUNT>{});
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (SIZE + 7) / 8;
+
+    static constexpr size_t wordLength(size_t word)
+    {
+        return (SIZE - word * 8 < 8) ? SIZE - word * 8 : 8;
+    }
+
+    static constexpr uint64_t wordMask(size_t word)
+    {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < wordLength(word); ++i) {
+            if (Pattern::BYTES[word * 8 + i] >= 0) {
+                mask |= uint64_t(0xFF) << (i * 8);
+            }
+        }
+        return mask;
+    }
+
+    static constexpr uint64_t wordValue(size_t word)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < wordLength(word); ++i) {
+            if (Pattern::BYTES[word * 8 + i] >= 0) {
+                value |= uint64_t(Pattern::BYTES[word * 8 + i]) << (i * 8);
+            }
+        }
+        return value;
+    }
+
+    template <size_t Word>
+    static bool compareWord(const uint8_t* data)
+    {
+        constexpr uint64_t MASK = wordMask(Word);
+        constexpr uint64_t VALUE = wordValue(Word);
+        constexpr size_t LENGTH = wordLength(Word);
+
+        if constexpr (MASK == 0) {
+            return true;
+        } else {
+            uint64_t word = 0;
+            std::memcpy(&word, data + Word * 8, LENGTH);
+            if constexpr (MASK == ~uint64_t(0) >> (64 - LENGTH * 8)) {
+                return word == VALUE;
+            } else {
+                return (word & MASK) == VALUE;
+            }
+        }
+    }
+
+    template <size_t... Words>
+    static bool compareWords(const uint8_t* data, std::index_sequence<Words...>)
+    {
+        return (compareWord<Words>(data) && ...);
+    }
+};
+
+#endif // STATICPATTERNMATCHER_H
@@ -0,0 +1,107 @@
+#ifndef STREAMSEARCHER_H
+#define STREAMSEARCHER_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Project includes
+#include "patternmatcher.h"
+#include "multipatternmatcher.h"
+
+struct StreamMatch {
+    uint64_t position;
+    size_t patternIndex;
+
+    bool found() const { return position != UINT64_MAX; }
+};
+
+// Runs a matcher over a byte stream delivered in arbitrary pieces. The last
+// (longest pattern - 1) bytes of each piece are carried over, so a match
+// straddling two pieces is found exactly as if the stream were contiguous.
+// Positions are reported relative to the value given to reset(), which lets
+// callers pass the remote base address of a region. With patterns of
+// different lengths a short match may complete, and be reported, before a
+// longer one that starts earlier. Searching stops at the first match; call
+// reset() before reusing the searcher
+template <typename Matcher>
+class StreamSearcher
+{
+public:
+    explicit StreamSearcher(const Matcher& matcher)
+        : m_matcher(matcher), m_span(spanOf(matcher)), m_position(0)
+    {
+        m_tail.reserve(m_span);
+        m_window.reserve(m_span * 2);
+    }
+
+    void reset(uint64_t position = 0)
+    {
+        m_tail.clear();
+        m_position = position;
+    }
+
+    StreamMatch feed(const uint8_t* data, size_t size)
+    {
+        if (m_span == 0) {
+            m_position += size;
+            return {UINT64_MAX, SIZE_MAX};
+        }
+
+        const size_t carry = m_span - 1;
+        const size_t head = (size < carry) ? size : carry;
+
+        m_window.assign(m_tail.begin(), m_tail.end());
+        m_window.insert(m_window.end(), data, data + head);
+
+        // Only matches starting inside the carried tail are new here; later
+        // ones are found below without the window's truncated view
+        if (!m_tail.empty()) {
+            MultiPatternMatcher::Match match = find(m_matcher, m_window.data(), m_window.size());
+            if (match.found() && match.offset < m_tail.size()) {
+                return {m_position - m_tail.size() + match.offset, match.patternIndex};
+            }
+        }
+
+        MultiPatternMatcher::Match match = find(m_matcher, data, size);
+        if (match.found()) {
+            return {m_position + match.offset, match.patternIndex};
+        }
+
+        if (size >= carry) {
+            m_tail.assign(data + size - carry, data + size);
+        } else {
+            size_t keep = (m_window.size() < carry) ? m_window.size() : carry;
+            m_tail.assign(m_window.end() - keep, m_window.end());
+        }
+
+        m_position += size;
+        return {UINT64_MAX, SIZE_MAX};
+    }
+
+    uint64_t position() const { return m_position; }
+
+private:
+    static size_t spanOf(const PatternMatcher& matcher) { return matcher.getPatternSize(); }
+    static size_t spanOf(const MultiPatternMatcher& matcher) { return matcher.getMaxPatternSize(); }
+
+    static MultiPatternMatcher::Match find(const PatternMatcher& matcher, const uint8_t* data, size_t size)
+    {
+        size_t offset = matcher.search(data, size);
+        return {offset, offset == SIZE_MAX ? SIZE_MAX : 0};
+    }
+
+    static MultiPatternMatcher::Match find(const MultiPatternMatcher& matcher, const uint8_t* data, size_t size)
+    {
+        return matcher.search(data, size);
+    }
+
+    const Matcher& m_matcher;
+    size_t m_span;
+    uint64_t m_position;
+    std::vector<uint8_t> m_tail;
+    std::vector<uint8_t> m_window;
+};
+
+#endif // STREAMSEARCHER_H
@@ -0,0 +1,96 @@
+#include "timerwheel.h"
+
+// STL includes
+#include <algorithm>
+
+TimerWheel::TimerWheel(int tickMs, size_t slotCount, Clock::time_point start)
+    : m_tick(tickMs > 0 ? tickMs : 1)
+    , m_start(start)
+    , m_slots(slotCount > 0 ? slotCount : 1)
+    , m_currentTick(0)
+    , m_nextId(1)
+    , m_pending(0)
+{
+}
+
+uint64_t TimerWheel::tickOf(Clock::time_point time) const
+{
+    if (time <= m_start) {
+        return 0;
+    }
+    return static_cast<uint64_t>((time - m_start) / m_tick);
+}
+
+uint64_t TimerWheel::schedule(Clock::time_point deadline, int value)
+{
+    // Round up so a timer never fires before its deadline
+    uint64_t dueTick = tickOf(deadline);
+    if (m_start + dueTick * m_tick < deadline) {
+        ++dueTick;
+    }
+    dueTick = std::max(dueTick, m_currentTick + 1);
+
+    uint64_t id = m_nextId++;
+    m_slots[dueTick % m_slots.size()].push_back({id, dueTick, value});
+    ++m_pending;
+    return id;
+}
+
+void TimerWheel::cancelAll()
+{
+    for (std::vector<Entry>& slot : m_slots) {
+        slot.clear();
+    }
+    m_pending = 0;
+}
+
+void TimerWheel::advance(Clock::time_point now, std::vector<Timer>& expired)
+{
+    const uint64_t target = tickOf(now);
+    if (target <= m_currentTick) {
+        return;
+    }
+
+    std::vector<Entry> fired;
+
+    // After a long gap every slot is visited once instead of every tick
+    const uint64_t steps = std::min<uint64_t>(target - m_currentTick, m_slots.size());
+    for (uint64_t step = 1; step <= steps && m_pending > 0; ++step) {
+        std::vector<Entry>& slot = m_slots[(m_currentTick + step) % m_slots.size()];
+        auto due = std::partition(slot.begin(), slot.end(), [target](const Entry& entry) {
+            return entry.dueTick > target;
+        });
+        fired.insert(fired.end(), due, slot.end());
+        m_pending -= static_cast<size_t>(slot.end() - due);
+        slot.erase(due, slot.end());
+    }
+
+    std::sort(fired.begin(), fired.end(), [](const Entry& a, const Entry& b) {
+        return (a.dueTick != b.dueTick) ? a.dueTick < b.dueTick : a.id < b.id;
+    });
+    for (const Entry& entry : fired) {
+        expired.push_back({entry.id, entry.value});
+    }
+
+    m_currentTick = target;
+}
+
+int TimerWheel::msUntilNext(Clock::time_point now) const
+{
+    if (m_pending == 0) {
+        return -1;
+    }
+
+    uint64_t earliest = UINT64_MAX;
+    for (const std::vector<Entry>& slot : m_slots) {
+        for (const Entry& entry : slot) {
+            earliest = std::min(earliest, entry.dueTick);
+        }
+    }
+
+    auto due = m_start + earliest * m_tick;
+    if (due <= now) {
+        return 0;
+    }
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(due - now).count());
+}
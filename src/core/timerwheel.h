@@ -0,0 +1,56 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+// STL includes
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hashed timing wheel for the autoplay loop. Timers land in the slot of
+// their deadline tick, and deadlines further out than one turn keep a round
+// count. Scheduling is O(1) and advancing touches only the slots passed
+// since the last call, so the loop can keep delayed actions pending without
+// sleeping on them. Single-threaded
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        uint64_t id;
+        int value;
+    };
+
+    TimerWheel(int tickMs, size_t slotCount, Clock::time_point start);
+
+    uint64_t schedule(Clock::time_point deadline, int value);
+    void cancelAll();
+
+    // Moves the wheel up to now and appends every timer that came due, in
+    // deadline order
+    void advance(Clock::time_point now, std::vector<Timer>& expired);
+
+    // Milliseconds until the earliest pending timer is due; -1 when none
+    int msUntilNext(Clock::time_point now) const;
+
+    size_t pending() const { return m_pending; }
+
+private:
+    struct Entry {
+        uint64_t id;
+        uint64_t dueTick;
+        int value;
+    };
+
+    uint64_t tickOf(Clock::time_point time) const;
+
+    const std::chrono::milliseconds m_tick;
+    const Clock::time_point m_start;
+    std::vector<std::vector<Entry>> m_slots;
+    uint64_t m_currentTick;
+    uint64_t m_nextId;
+    size_t m_pending;
+};
+
+#endif // TIMERWHEEL_H
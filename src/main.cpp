@@ -3,15 +3,26 @@
 #include "utils/updatemanager.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
     QQmlApplicationEngine engine;
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption snapshotOption("snapshot", "Scan a recorded snapshot instead of the running game", "file");
+    parser.addOption(snapshotOption);
+    parser.process(app);
+
     MemoryScanner scanner;
     UpdateManager updateManager;
 
+    if (parser.isSet(snapshotOption)) {
+        scanner.setSnapshotPath(parser.value(snapshotOption));
+    }
+
     AppController controller(&scanner, &updateManager);
 
     engine.rootContext()->setContextProperty("scanner", &scanner);
@@ -0,0 +1,376 @@
+#include "linuxprocessmemory.h"
+
+// STL includes
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// System includes
+#include <dirent.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+namespace {
+
+// The kernel truncates comm to 15 characters
+constexpr size_t COMM_LENGTH = 15;
+
+// process_vm_readv takes at most IOV_MAX (1024) entries per side
+constexpr size_t MAX_IOV = 1024;
+
+std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return text;
+}
+
+std::string baseName(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+bool endsWith(const std::string& text, const char* suffix)
+{
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+} // namespace
+
+uint32_t IProcessMemory::findProcessId(const std::string& processName)
+{
+    const std::string wanted = toLower(processName).substr(0, COMM_LENGTH);
+
+    DIR* proc = opendir("/proc");
+    if (!proc) {
+        return 0;
+    }
+
+    uint32_t pid = 0;
+    while (dirent* entry = readdir(proc)) {
+        char* end = nullptr;
+        long candidate = std::strtol(entry->d_name, &end, 10);
+        if (candidate <= 0 || *end != '\0') {
+            continue;
+        }
+
+        std::string comm = LinuxProcessMemory::readProcFile(static_cast<pid_t>(candidate), "comm");
+        while (!comm.empty() && (comm.back() == '\n' || comm.back() == '\r')) {
+            comm.pop_back();
+        }
+
+        if (toLower(comm) == wanted) {
+            pid = static_cast<uint32_t>(candidate);
+            break;
+        }
+    }
+
+    closedir(proc);
+    return pid;
+}
+
+std::unique_ptr<IProcessMemory> IProcessMemory::open(uint32_t processId)
+{
+    if (processId == 0) {
+        return nullptr;
+    }
+
+    auto process = std::make_unique<LinuxProcessMemory>(static_cast<pid_t>(processId));
+    if (!process->isAlive()) {
+        std::fprintf(stderr, "[ERROR] Failed to open process PID: %u\n", processId);
+        return nullptr;
+    }
+
+    // A zero-length read still checks ptrace permission
+    struct iovec local = {nullptr, 0};
+    struct iovec remote = {nullptr, 0};
+    if (process_vm_readv(static_cast<pid_t>(processId), &local, 1, &remote, 1, 0) < 0 && errno == EPERM) {
+        std::fprintf(stderr, "[ERROR] No ptrace access to PID %u (check kernel.yama.ptrace_scope)\n", processId);
+        return nullptr;
+    }
+
+    return process;
+}
+
+LinuxProcessMemory::LinuxProcessMemory(pid_t processId)
+    : m_processId(processId)
+    , m_startTime(startTime(processId))
+    , m_pidFd(static_cast<int>(syscall(SYS_pidfd_open, processId, 0)))
+    , m_interruptFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+}
+
+LinuxProcessMemory::~LinuxProcessMemory()
+{
+    if (m_pidFd >= 0) {
+        ::close(m_pidFd);
+    }
+    if (m_interruptFd >= 0) {
+        ::close(m_interruptFd);
+    }
+}
+
+std::string LinuxProcessMemory::readProcFile(pid_t processId, const char* name)
+{
+    std::ifstream file("/proc/" + std::to_string(processId) + "/" + name);
+    if (!file) {
+        return std::string();
+    }
+
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+unsigned long long LinuxProcessMemory::startTime(pid_t processId)
+{
+    std::string stat = readProcFile(processId, "stat");
+
+    // comm may contain spaces and parentheses, so count fields after the last ')'
+    size_t close = stat.rfind(')');
+    if (close == std::string::npos) {
+        return 0;
+    }
+
+    std::istringstream fields(stat.substr(close + 2));
+    std::string field;
+    for (int index = 3; index <= 22 && (fields >> field); ++index) {
+        if (index == 22) {
+            return std::strtoull(field.c_str(), nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+bool LinuxProcessMemory::isAlive() const
+{
+    // The pidfd pins this exact process, so one zero-timeout poll answers
+    // without touching /proc or being fooled by PID reuse
+    if (m_pidFd >= 0) {
+        struct pollfd fd = {m_pidFd, POLLIN, 0};
+        return poll(&fd, 1, 0) == 0;
+    }
+
+    if (kill(m_processId, 0) != 0 && errno != EPERM) {
+        return false;
+    }
+
+    std::string stat = readProcFile(m_processId, "stat");
+    size_t close = stat.rfind(')');
+    if (close == std::string::npos || close + 2 >= stat.size()) {
+        return false;
+    }
+
+    char state = stat[close + 2];
+    if (state == 'Z' || state == 'X') {
+        return false;
+    }
+
+    return startTime(m_processId) == m_startTime;
+}
+
+std::string LinuxProcessMemory::modulePath() const
+{
+    std::string comm = readProcFile(m_processId, "comm");
+    while (!comm.empty() && (comm.back() == '\n' || comm.back() == '\r')) {
+        comm.pop_back();
+    }
+    comm = toLower(comm);
+
+    // Under Wine /proc/<pid>/exe points at the loader, so look for the mapped
+    // image whose name matches the process name instead
+    std::istringstream maps(readProcFile(m_processId, "maps"));
+    std::string line;
+    while (std::getline(maps, line)) {
+        size_t slash = line.find('/');
+        if (slash == std::string::npos) {
+            continue;
+        }
+
+        std::string path = line.substr(slash);
+        if (!comm.empty() && toLower(baseName(path)).compare(0, comm.size(), comm) == 0) {
+            return path;
+        }
+    }
+
+    char buffer[4096];
+    ssize_t length = readlink(("/proc/" + std::to_string(m_processId) + "/exe").c_str(), buffer, sizeof(buffer) - 1);
+    if (length <= 0) {
+        return std::string();
+    }
+    return std::string(buffer, static_cast<size_t>(length));
+}
+
+std::vector<MemoryRegion> LinuxProcessMemory::enumerateRegions() const
+{
+    std::vector<MemoryRegion> regions;
+
+    std::istringstream maps(readProcFile(m_processId, "maps"));
+    std::string line;
+    while (std::getline(maps, line)) {
+        // start-end perms offset dev inode [path]
+        unsigned long long start = 0;
+        unsigned long long end = 0;
+        char perms[5] = {};
+        int consumed = 0;
+        if (std::sscanf(line.c_str(), "%llx-%llx %4s %*s %*s %*s %n", &start, &end, perms, &consumed) < 3 || end <= start) {
+            continue;
+        }
+
+        std::string path = (consumed > 0 && static_cast<size_t>(consumed) <= line.size()) ? line.substr(consumed) : std::string();
+
+        uint32_t protection = 0;
+        if (perms[0] == 'r') protection |= MemoryProtection::READ;
+        if (perms[1] == 'w') protection |= MemoryProtection::WRITE;
+        if (perms[2] == 'x') protection |= MemoryProtection::EXECUTE;
+
+        // [vvar] and friends can't be read through process_vm_readv
+        if (path == "[vvar]" || path == "[vsyscall]" || path == "[vvar_vclock]") {
+            protection &= ~MemoryProtection::READ;
+        }
+
+        RegionType type = RegionType::Private;
+        if (!path.empty() && path[0] == '/') {
+            const bool shared = (perms[3] == 's');
+            const std::string lower = toLower(path);
+            const bool image = endsWith(lower, ".exe") || endsWith(lower, ".dll") || lower.find(".so") != std::string::npos;
+            type = (!shared && image) ? RegionType::Image : RegionType::Mapped;
+            if (perms[3] == 'p' && (protection & MemoryProtection::WRITE)) {
+                protection |= MemoryProtection::COPY_ON_WRITE;
+            }
+        }
+
+        regions.push_back({static_cast<uintptr_t>(start), static_cast<size_t>(end - start), protection, type});
+    }
+
+    return regions;
+}
+
+size_t LinuxProcessMemory::read(uintptr_t address, void* buffer, size_t size) const
+{
+    if (!buffer || size == 0) {
+        return 0;
+    }
+
+    struct iovec local = {buffer, size};
+    struct iovec remote = {reinterpret_cast<void*>(address), size};
+    ssize_t bytesRead = process_vm_readv(m_processId, &local, 1, &remote, 1, 0);
+    countSyscalls();
+    return (bytesRead < 0) ? 0 : static_cast<size_t>(bytesRead);
+}
+
+size_t LinuxProcessMemory::readBatch(ReadSpan* spans, size_t count) const
+{
+    size_t complete = 0;
+    size_t first = 0;
+
+    while (first < count) {
+        const size_t batch = std::min(count - first, MAX_IOV);
+        struct iovec local[MAX_IOV];
+        struct iovec remote[MAX_IOV];
+        for (size_t i = 0; i < batch; ++i) {
+            ReadSpan& span = spans[first + i];
+            span.bytesRead = 0;
+            local[i] = {span.destination, span.size};
+            remote[i] = {reinterpret_cast<void*>(span.address), span.size};
+        }
+
+        ssize_t result = process_vm_readv(m_processId, local, batch, remote, batch, 0);
+        countSyscalls();
+        size_t remaining = (result < 0) ? 0 : static_cast<size_t>(result);
+
+        size_t i = 0;
+        for (; i < batch && remaining >= spans[first + i].size; ++i) {
+            spans[first + i].bytesRead = spans[first + i].size;
+            remaining -= spans[first + i].size;
+            ++complete;
+        }
+
+        // The kernel stops at the first remote fault, so the span it stopped
+        // in and everything after it are retried one by one
+        for (; i < batch; ++i) {
+            ReadSpan& span = spans[first + i];
+            span.bytesRead = read(span.address, span.destination, span.size);
+            if (span.bytesRead == span.size) {
+                ++complete;
+            }
+        }
+
+        first += batch;
+    }
+
+    return complete;
+}
+
+bool LinuxProcessMemory::write(uintptr_t address, const void* buffer, size_t size) const
+{
+    if (!buffer || size == 0) {
+        return false;
+    }
+
+    struct iovec local = {const_cast<void*>(buffer), size};
+    struct iovec remote = {reinterpret_cast<void*>(address), size};
+    ssize_t bytesWritten = process_vm_writev(m_processId, &local, 1, &remote, 1, 0);
+    countSyscalls();
+    if (bytesWritten < 0) {
+        std::fprintf(stderr, "[ERROR] Failed to write memory at address %llx errno: %d\n",
+                     static_cast<unsigned long long>(address), errno);
+        return false;
+    }
+    return static_cast<size_t>(bytesWritten) == size;
+}
+
+bool LinuxProcessMemory::waitForExit(int timeoutMs) const
+{
+    if (m_interruptFd < 0) {
+        return IProcessMemory::waitForExit(timeoutMs);
+    }
+
+    // A pidfd turns readable when the process exits; without one the wait
+    // only ends on timeout or interrupt and liveness is checked after
+    struct pollfd fds[2] = {
+        {m_interruptFd, POLLIN, 0},
+        {m_pidFd, POLLIN, 0}
+    };
+    const nfds_t count = (m_pidFd >= 0) ? 2 : 1;
+
+    int ready = poll(fds, count, timeoutMs);
+    if (ready > 0 && (fds[0].revents & POLLIN)) {
+        uint64_t value;
+        ssize_t drained = ::read(m_interruptFd, &value, sizeof(value));
+        (void)drained;
+    }
+
+    if (m_pidFd >= 0) {
+        return ready > 0 && (fds[1].revents & (POLLIN | POLLHUP));
+    }
+    return !isAlive();
+}
+
+void LinuxProcessMemory::interruptWait() const
+{
+    if (m_interruptFd < 0) {
+        IProcessMemory::interruptWait();
+        return;
+    }
+
+    uint64_t value = 1;
+    ssize_t written = ::write(m_interruptFd, &value, sizeof(value));
+    (void)written;
+}
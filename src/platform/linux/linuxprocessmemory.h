@@ -0,0 +1,45 @@
+#ifndef LINUXPROCESSMEMORY_H
+#define LINUXPROCESSMEMORY_H
+
+// STL includes
+#include <string>
+
+// System includes
+#include <sys/types.h>
+
+// Project includes
+#include "../processmemory.h"
+
+// Reads the target through process_vm_readv/writev, which needs the same
+// ptrace access as attaching a debugger (same user with ptrace_scope 0, or
+// CAP_SYS_PTRACE). Regions come from /proc/<pid>/maps, which lists the Wine
+// address space of a Windows game the same way as a native one
+class LinuxProcessMemory : public IProcessMemory
+{
+public:
+    explicit LinuxProcessMemory(pid_t processId);
+    ~LinuxProcessMemory() override;
+
+    uint32_t processId() const override { return static_cast<uint32_t>(m_processId); }
+    bool isAlive() const override;
+    std::string modulePath() const override;
+    std::vector<MemoryRegion> enumerateRegions() const override;
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    size_t readBatch(ReadSpan* spans, size_t count) const override;
+    bool write(uintptr_t address, const void* buffer, size_t size) const override;
+    bool waitForExit(int timeoutMs) const override;
+    void interruptWait() const override;
+
+    static std::string readProcFile(pid_t processId, const char* name);
+
+private:
+    // Field 22 of /proc/<pid>/stat; a recycled PID gets a different value
+    static unsigned long long startTime(pid_t processId);
+
+    pid_t m_processId;
+    unsigned long long m_startTime;
+    int m_pidFd;        // -1 on kernels before 5.3
+    int m_interruptFd;  // eventfd that wakes waitForExit()
+};
+
+#endif // LINUXPROCESSMEMORY_H
@@ -0,0 +1,35 @@
+#include "processmemory.h"
+
+// STL includes
+#include <chrono>
+
+size_t IProcessMemory::readBatch(ReadSpan* spans, size_t count) const
+{
+    size_t complete = 0;
+    for (size_t i = 0; i < count; ++i) {
+        spans[i].bytesRead = read(spans[i].address, spans[i].destination, spans[i].size);
+        if (spans[i].bytesRead == spans[i].size) {
+            ++complete;
+        }
+    }
+    return complete;
+}
+
+bool IProcessMemory::waitForExit(int timeoutMs) const
+{
+    {
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waitCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return m_waitInterrupted; });
+        m_waitInterrupted = false;
+    }
+    return !isAlive();
+}
+
+void IProcessMemory::interruptWait() const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_waitInterrupted = true;
+    }
+    m_waitCondition.notify_all();
+}
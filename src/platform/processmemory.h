@@ -0,0 +1,104 @@
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+// STL includes
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MemoryProtection {
+    constexpr uint32_t READ = 1 << 0;
+    constexpr uint32_t WRITE = 1 << 1;
+    constexpr uint32_t EXECUTE = 1 << 2;
+    constexpr uint32_t COPY_ON_WRITE = 1 << 3;
+    constexpr uint32_t GUARD = 1 << 4;
+}
+
+enum class RegionType { Private, Image, Mapped };
+
+struct MemoryRegion {
+    uintptr_t base;
+    size_t size;
+    uint32_t protection;
+    RegionType type;
+
+    bool isReadable() const {
+        return (protection & MemoryProtection::READ) && !(protection & MemoryProtection::GUARD);
+    }
+};
+
+struct ReadSpan {
+    uintptr_t address;
+    size_t size;
+    void* destination;
+    size_t bytesRead;
+};
+
+// Access to another process's address space. Implementations are selected at
+// build time (Windows, Linux) and must allow concurrent reads from several
+// threads
+class IProcessMemory
+{
+public:
+    virtual ~IProcessMemory() = default;
+
+    virtual uint32_t processId() const = 0;
+    virtual bool isAlive() const = 0;
+
+    // UTF-8 path of the main executable image
+    virtual std::string modulePath() const = 0;
+
+    // MD5 of the main image when the backend already knows it (snapshots
+    // record it); empty means callers hash the file at modulePath()
+    virtual std::string moduleMD5() const { return std::string(); }
+
+    // Committed regions in ascending address order
+    virtual std::vector<MemoryRegion> enumerateRegions() const = 0;
+
+    // Returns the number of bytes copied, which is less than size when the
+    // range runs into an unreadable page
+    virtual size_t read(uintptr_t address, void* buffer, size_t size) const = 0;
+
+    // Fills bytesRead of every span; returns how many spans were read in full.
+    // Backends complete the batch in as few system calls as the OS allows
+    virtual size_t readBatch(ReadSpan* spans, size_t count) const;
+
+    // Pointer to size bytes at address when the backend holds them locally
+    // and contiguously, nullptr otherwise. Lets scans skip the copy
+    virtual const uint8_t* view(uintptr_t address, size_t size) const { (void)address; (void)size; return nullptr; }
+
+    virtual bool write(uintptr_t address, const void* buffer, size_t size) const = 0;
+
+    // Blocks until the process exits, interruptWait() is called or timeoutMs
+    // passes, without polling; returns true once the process is gone. An
+    // interrupt raised while nobody waits is kept for the next call
+    virtual bool waitForExit(int timeoutMs) const;
+    virtual void interruptWait() const;
+
+    // Read and write system calls issued so far, from all threads
+    uint64_t getSyscallCount() const { return m_syscalls.load(std::memory_order_relaxed); }
+    void resetSyscallCount() { m_syscalls.store(0, std::memory_order_relaxed); }
+
+    // Implemented by the platform backend compiled into the build
+    static uint32_t findProcessId(const std::string& processName);
+    static std::unique_ptr<IProcessMemory> open(uint32_t processId);
+
+protected:
+    void countSyscalls(uint64_t count = 1) const { m_syscalls.fetch_add(count, std::memory_order_relaxed); }
+
+private:
+    mutable std::atomic<uint64_t> m_syscalls{0};
+
+    // Used by the default waitForExit(), which sleeps on a condition variable
+    // and checks isAlive() afterwards
+    mutable std::mutex m_waitMutex;
+    mutable std::condition_variable m_waitCondition;
+    mutable bool m_waitInterrupted = false;
+};
+
+#endif // PROCESSMEMORY_H
@@ -0,0 +1,70 @@
+#include "processsession.h"
+
+ProcessSession::ProcessSession(std::string processName)
+    : m_processName(std::move(processName))
+    , m_generation(0)
+    , m_exited(false)
+    , m_lookups(0)
+{
+}
+
+bool ProcessSession::attach()
+{
+    if (refresh()) {
+        return true;
+    }
+
+    ++m_lookups;
+    uint32_t processId = IProcessMemory::findProcessId(m_processName);
+    std::unique_ptr<IProcessMemory> process = processId ? IProcessMemory::open(processId) : nullptr;
+    if (!process) {
+        m_process.reset();
+        return false;
+    }
+
+    m_process = std::move(process);
+    m_exited.store(false, std::memory_order_release);
+    nextGeneration();
+    return true;
+}
+
+void ProcessSession::adopt(std::unique_ptr<IProcessMemory> process)
+{
+    m_process = std::move(process);
+    m_exited.store(!m_process, std::memory_order_release);
+    nextGeneration();
+}
+
+bool ProcessSession::refresh()
+{
+    if (!isAttached()) {
+        return false;
+    }
+
+    if (!m_process->isAlive()) {
+        markExited();
+        return false;
+    }
+    return true;
+}
+
+void ProcessSession::markExited()
+{
+    if (m_process && !m_exited.exchange(true, std::memory_order_acq_rel)) {
+        nextGeneration();
+    }
+}
+
+void ProcessSession::reset()
+{
+    if (m_process) {
+        m_process.reset();
+        m_exited.store(false, std::memory_order_release);
+        nextGeneration();
+    }
+}
+
+void ProcessSession::nextGeneration()
+{
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,60 @@
+#ifndef PROCESSSESSION_H
+#define PROCESSSESSION_H
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Project includes
+#include "processmemory.h"
+
+// Owns the one open handle to the game. The PID is resolved by name only
+// when no live process is attached, so repeated toggles and the autoplay
+// loop never walk the process list. Exit is detected through the handle or
+// pidfd, and every attach or detected exit bumps a generation counter:
+// addresses found in one generation stay valid exactly as long as the
+// counter still reads the same
+class ProcessSession
+{
+public:
+    explicit ProcessSession(std::string processName);
+
+    // Keeps the current process while it is alive, otherwise looks the name
+    // up and opens the new one. Returns false when the game isn't running
+    bool attach();
+
+    // Takes over an already opened backend, e.g. a snapshot file
+    void adopt(std::unique_ptr<IProcessMemory> process);
+
+    // Zero-timeout check on the handle. Returns false, and starts a new
+    // generation, the first time the process is seen gone
+    bool refresh();
+
+    // Records an exit that someone else already observed, e.g. the
+    // autoplay engine waking up in waitForExit()
+    void markExited();
+
+    void reset();
+
+    bool isAttached() const { return m_process && !m_exited.load(std::memory_order_acquire); }
+    uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    IProcessMemory* process() const { return m_process.get(); }
+    uint32_t processId() const { return m_process ? m_process->processId() : 0; }
+
+    // Number of by-name PID lookups so far, for the logs
+    uint64_t getLookupCount() const { return m_lookups; }
+
+private:
+    void nextGeneration();
+
+    const std::string m_processName;
+    std::unique_ptr<IProcessMemory> m_process;
+    std::atomic<uint64_t> m_generation;
+    std::atomic<bool> m_exited;
+    uint64_t m_lookups;
+};
+
+#endif // PROCESSSESSION_H
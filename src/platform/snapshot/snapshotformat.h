@@ -0,0 +1,60 @@
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layout of a process memory snapshot (.bbasnap). All fields are
+// little-endian and every offset is absolute from the start of the file.
+//
+//   SnapshotHeader
+//   SnapshotRegion[regionCount], sorted by base
+//   module path (UTF-8, not terminated)
+//   payloads, each starting on a SNAPSHOT_PAGE_SIZE boundary
+//
+// An uncompressed region stores its bytes contiguously at payloadOffset. A
+// region in a snapshot with SNAPSHOT_FLAG_ZERO_PAGES instead points at a
+// table of one uint64_t per page: 0 marks an all-zero page that isn't
+// stored, anything else is the offset of that page's bytes. Stored pages
+// of a region are written in order, so runs of non-zero pages stay
+// contiguous and can still be searched in place
+namespace Snapshot {
+    constexpr char MAGIC[8] = {'B', 'B', 'A', 'S', 'N', 'A', 'P', '\0'};
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint32_t PAGE_SIZE = 4096;
+
+    constexpr uint32_t FLAG_ZERO_PAGES = 1 << 0;
+
+    constexpr const char* FILE_EXTENSION = ".bbasnap";
+}
+
+#pragma pack(push, 1)
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t processId;
+    uint32_t regionCount;
+    uint64_t regionTableOffset;
+    uint64_t modulePathOffset;
+    uint32_t modulePathSize;
+    uint32_t pageSize;
+    char moduleMD5[32];
+};
+
+struct SnapshotRegion {
+    uint64_t base;
+    uint64_t size;
+    uint32_t protection;
+    uint32_t type;
+    uint64_t payloadOffset;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(SnapshotHeader) == 80, "SnapshotHeader layout changed");
+static_assert(sizeof(SnapshotRegion) == 32, "SnapshotRegion layout changed");
+
+#endif // SNAPSHOTFORMAT_H
@@ -0,0 +1,210 @@
+#include "snapshotprocessmemory.h"
+
+// STL includes
+#include <algorithm>
+#include <cstring>
+
+std::unique_ptr<SnapshotProcessMemory> SnapshotProcessMemory::open(const std::string& path, std::string& error)
+{
+    std::unique_ptr<SnapshotProcessMemory> snapshot(new SnapshotProcessMemory());
+    if (!snapshot->load(path, error)) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+bool SnapshotProcessMemory::load(const std::string& path, std::string& error)
+{
+    if (!m_file.open(path)) {
+        error = m_file.getLastError();
+        return false;
+    }
+
+    const uint8_t* data = m_file.data();
+    const uint64_t fileSize = m_file.size();
+
+    SnapshotHeader header;
+    if (fileSize < sizeof(header)) {
+        error = "File is too small to be a snapshot";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, Snapshot::MAGIC, sizeof(header.magic)) != 0) {
+        error = "Not a snapshot file";
+        return false;
+    }
+    if (header.version != Snapshot::FORMAT_VERSION) {
+        error = "Unsupported snapshot version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.pageSize != Snapshot::PAGE_SIZE) {
+        error = "Unsupported snapshot page size";
+        return false;
+    }
+
+    const uint64_t tableSize = static_cast<uint64_t>(header.regionCount) * sizeof(SnapshotRegion);
+    if (header.regionTableOffset > fileSize || tableSize > fileSize - header.regionTableOffset ||
+        header.modulePathOffset > fileSize || header.modulePathSize > fileSize - header.modulePathOffset) {
+        error = "Snapshot header points outside the file";
+        return false;
+    }
+
+    m_flags = header.flags;
+    m_processId = header.processId;
+    m_modulePath.assign(reinterpret_cast<const char*>(data + header.modulePathOffset), header.modulePathSize);
+    m_moduleMD5.assign(header.moduleMD5, strnlen(header.moduleMD5, sizeof(header.moduleMD5)));
+
+    m_regions.resize(header.regionCount);
+    if (tableSize > 0) {
+        std::memcpy(m_regions.data(), data + header.regionTableOffset, tableSize);
+    }
+
+    // Everything a read can touch is checked once here, so read() and
+    // view() don't have to
+    uint64_t previousEnd = 0;
+    for (const SnapshotRegion& region : m_regions) {
+        if (region.size == 0 || region.base < previousEnd || region.base + region.size < region.base) {
+            error = "Snapshot regions overlap or aren't sorted";
+            return false;
+        }
+        previousEnd = region.base + region.size;
+
+        if (m_flags & Snapshot::FLAG_ZERO_PAGES) {
+            const uint64_t pages = (region.size + Snapshot::PAGE_SIZE - 1) / Snapshot::PAGE_SIZE;
+            if (region.payloadOffset > fileSize || pages * sizeof(uint64_t) > fileSize - region.payloadOffset) {
+                error = "Snapshot page table points outside the file";
+                return false;
+            }
+            for (uint64_t page = 0; page < pages; ++page) {
+                uint64_t offset = pageOffset(region, page);
+                uint64_t length = std::min<uint64_t>(Snapshot::PAGE_SIZE, region.size - page * Snapshot::PAGE_SIZE);
+                if (offset != 0 && (offset > fileSize || length > fileSize - offset)) {
+                    error = "Snapshot page points outside the file";
+                    return false;
+                }
+            }
+        } else if (region.payloadOffset > fileSize || region.size > fileSize - region.payloadOffset) {
+            error = "Snapshot payload points outside the file";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<MemoryRegion> SnapshotProcessMemory::enumerateRegions() const
+{
+    std::vector<MemoryRegion> regions;
+    regions.reserve(m_regions.size());
+
+    for (const SnapshotRegion& region : m_regions) {
+        regions.push_back({static_cast<uintptr_t>(region.base), static_cast<size_t>(region.size),
+            region.protection, static_cast<RegionType>(region.type)});
+    }
+    return regions;
+}
+
+const SnapshotRegion* SnapshotProcessMemory::findRegion(uintptr_t address) const
+{
+    auto it = std::upper_bound(m_regions.begin(), m_regions.end(), static_cast<uint64_t>(address),
+        [](uint64_t value, const SnapshotRegion& region) { return value < region.base; });
+
+    if (it == m_regions.begin()) {
+        return nullptr;
+    }
+    --it;
+    return (address - it->base < it->size) ? &*it : nullptr;
+}
+
+uint64_t SnapshotProcessMemory::pageOffset(const SnapshotRegion& region, size_t page) const
+{
+    uint64_t offset;
+    std::memcpy(&offset, m_file.data() + region.payloadOffset + page * sizeof(uint64_t), sizeof(offset));
+    return offset;
+}
+
+void SnapshotProcessMemory::copyFromRegion(const SnapshotRegion& region, uint64_t offset, uint8_t* destination,
+                                           size_t size) const
+{
+    if (!(m_flags & Snapshot::FLAG_ZERO_PAGES)) {
+        std::memcpy(destination, m_file.data() + region.payloadOffset + offset, size);
+        return;
+    }
+
+    while (size > 0) {
+        size_t page = static_cast<size_t>(offset / Snapshot::PAGE_SIZE);
+        size_t inPage = static_cast<size_t>(offset % Snapshot::PAGE_SIZE);
+        size_t length = std::min<size_t>(size, Snapshot::PAGE_SIZE - inPage);
+
+        uint64_t stored = pageOffset(region, page);
+        if (stored == 0) {
+            std::memset(destination, 0, length);
+        } else {
+            std::memcpy(destination, m_file.data() + stored + inPage, length);
+        }
+
+        destination += length;
+        offset += length;
+        size -= length;
+    }
+}
+
+size_t SnapshotProcessMemory::read(uintptr_t address, void* buffer, size_t size) const
+{
+    uint8_t* destination = static_cast<uint8_t*>(buffer);
+    size_t copied = 0;
+
+    // Like a live read, a range may run across adjacent regions
+    while (copied < size) {
+        const SnapshotRegion* region = findRegion(address + copied);
+        if (!region) {
+            break;
+        }
+
+        uint64_t offset = address + copied - region->base;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(size - copied, region->size - offset));
+        copyFromRegion(*region, offset, destination + copied, length);
+        copied += length;
+    }
+
+    return copied;
+}
+
+const uint8_t* SnapshotProcessMemory::view(uintptr_t address, size_t size) const
+{
+    const SnapshotRegion* region = findRegion(address);
+    if (!region || size == 0) {
+        return nullptr;
+    }
+
+    uint64_t offset = address - region->base;
+    if (size > region->size - offset) {
+        return nullptr;
+    }
+
+    if (!(m_flags & Snapshot::FLAG_ZERO_PAGES)) {
+        return m_file.data() + region->payloadOffset + offset;
+    }
+
+    // Only a run of stored pages laid out back to back can be viewed
+    size_t first = static_cast<size_t>(offset / Snapshot::PAGE_SIZE);
+    size_t last = static_cast<size_t>((offset + size - 1) / Snapshot::PAGE_SIZE);
+    uint64_t start = pageOffset(*region, first);
+    if (start == 0) {
+        return nullptr;
+    }
+
+    for (size_t page = first + 1; page <= last; ++page) {
+        if (pageOffset(*region, page) != start + (page - first) * Snapshot::PAGE_SIZE) {
+            return nullptr;
+        }
+    }
+
+    return m_file.data() + start + offset % Snapshot::PAGE_SIZE;
+}
+
+bool SnapshotProcessMemory::write(uintptr_t, const void*, size_t) const
+{
+    return false;
+}
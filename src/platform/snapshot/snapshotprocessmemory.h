@@ -0,0 +1,51 @@
+#ifndef SNAPSHOTPROCESSMEMORY_H
+#define SNAPSHOTPROCESSMEMORY_H
+
+// STL includes
+#include <memory>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "snapshotformat.h"
+#include "../processmemory.h"
+#include "../../utils/mappedfile.h"
+
+// Serves a recorded snapshot as if it were the live game. The file is
+// mapped, not loaded, and view() hands out pointers straight into the
+// mapping, so scanning a snapshot costs no copies. The process reports
+// itself alive and refuses writes
+class SnapshotProcessMemory : public IProcessMemory
+{
+public:
+    static std::unique_ptr<SnapshotProcessMemory> open(const std::string& path, std::string& error);
+
+    uint32_t processId() const override { return m_processId; }
+    bool isAlive() const override { return true; }
+    std::string modulePath() const override { return m_modulePath; }
+    std::string moduleMD5() const override { return m_moduleMD5; }
+    std::vector<MemoryRegion> enumerateRegions() const override;
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    const uint8_t* view(uintptr_t address, size_t size) const override;
+    bool write(uintptr_t address, const void* buffer, size_t size) const override;
+
+    uint32_t getFlags() const { return m_flags; }
+    size_t getFileSize() const { return m_file.size(); }
+
+private:
+    SnapshotProcessMemory() = default;
+
+    bool load(const std::string& path, std::string& error);
+    const SnapshotRegion* findRegion(uintptr_t address) const;
+    uint64_t pageOffset(const SnapshotRegion& region, size_t page) const;
+    void copyFromRegion(const SnapshotRegion& region, uint64_t offset, uint8_t* destination, size_t size) const;
+
+    MappedFile m_file;
+    uint32_t m_flags = 0;
+    uint32_t m_processId = 0;
+    std::string m_modulePath;
+    std::string m_moduleMD5;
+    std::vector<SnapshotRegion> m_regions;
+};
+
+#endif // SNAPSHOTPROCESSMEMORY_H
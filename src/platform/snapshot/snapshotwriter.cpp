@@ -0,0 +1,162 @@
+#include "snapshotwriter.h"
+
+// STL includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Project includes
+#include "../../utils/constants.h"
+
+namespace {
+
+bool isZeroPage(const uint8_t* data, size_t size)
+{
+    static const uint8_t zeros[Snapshot::PAGE_SIZE] = {};
+    return std::memcmp(data, zeros, size) == 0;
+}
+
+void padTo(std::ofstream& out, uint64_t alignment)
+{
+    static const char zeros[Snapshot::PAGE_SIZE] = {};
+    uint64_t position = static_cast<uint64_t>(out.tellp());
+    uint64_t padding = (alignment - position % alignment) % alignment;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+}
+
+} // namespace
+
+SnapshotWriter::SnapshotWriter(const IProcessMemory& process)
+    : m_process(process)
+    , m_compressZeroPages(true)
+    , m_filter([](const MemoryRegion& region) { return region.isReadable(); })
+    , m_regionCount(0)
+    , m_bytesCaptured(0)
+    , m_bytesWritten(0)
+    , m_zeroPages(0)
+    , m_unreadablePages(0)
+{
+}
+
+// Reads as much of the range as possible; a page that faults is zeroed and
+// reading resumes on the page after it
+void SnapshotWriter::readFully(uintptr_t address, uint8_t* buffer, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+        done += m_process.read(address + done, buffer + done, size - done);
+        if (done >= size) {
+            break;
+        }
+
+        size_t skip = std::min<size_t>(size - done, Snapshot::PAGE_SIZE - (address + done) % Snapshot::PAGE_SIZE);
+        std::memset(buffer + done, 0, skip);
+        done += skip;
+        ++m_unreadablePages;
+    }
+}
+
+bool SnapshotWriter::write(const std::string& path)
+{
+    m_regionCount = 0;
+    m_bytesCaptured = 0;
+    m_bytesWritten = 0;
+    m_zeroPages = 0;
+    m_unreadablePages = 0;
+    m_lastError.clear();
+
+    std::vector<MemoryRegion> regions;
+    for (const MemoryRegion& region : m_process.enumerateRegions()) {
+        if (region.size > 0 && (!m_filter || m_filter(region))) {
+            regions.push_back(region);
+        }
+    }
+    std::sort(regions.begin(), regions.end(), [](const MemoryRegion& a, const MemoryRegion& b) {
+        return a.base < b.base;
+    });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        m_lastError = "Couldn't create " + path;
+        return false;
+    }
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, Snapshot::MAGIC, sizeof(header.magic));
+    header.version = Snapshot::FORMAT_VERSION;
+    header.flags = m_compressZeroPages ? Snapshot::FLAG_ZERO_PAGES : 0;
+    header.processId = m_process.processId();
+    header.regionCount = static_cast<uint32_t>(regions.size());
+    header.regionTableOffset = sizeof(SnapshotHeader);
+    header.pageSize = Snapshot::PAGE_SIZE;
+    std::memcpy(header.moduleMD5, m_moduleMD5.data(), std::min(m_moduleMD5.size(), sizeof(header.moduleMD5)));
+
+    const std::string modulePath = m_process.modulePath();
+    header.modulePathOffset = header.regionTableOffset + regions.size() * sizeof(SnapshotRegion);
+    header.modulePathSize = static_cast<uint32_t>(modulePath.size());
+
+    // Header and region table are rewritten once the payload offsets are known
+    std::vector<SnapshotRegion> table(regions.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SnapshotRegion)));
+    out.write(modulePath.data(), static_cast<std::streamsize>(modulePath.size()));
+
+    std::vector<std::vector<uint64_t>> pageTables(regions.size());
+    std::vector<uint8_t> buffer(Constants::MEMORY_CHUNK_SIZE);
+
+    for (size_t index = 0; index < regions.size() && out; ++index) {
+        const MemoryRegion& region = regions[index];
+        table[index] = {region.base, region.size, region.protection, static_cast<uint32_t>(region.type), 0};
+
+        padTo(out, Snapshot::PAGE_SIZE);
+        if (!m_compressZeroPages) {
+            table[index].payloadOffset = static_cast<uint64_t>(out.tellp());
+        }
+
+        for (size_t offset = 0; offset < region.size && out; offset += buffer.size()) {
+            size_t chunkSize = std::min(buffer.size(), region.size - offset);
+            readFully(region.base + offset, buffer.data(), chunkSize);
+            m_bytesCaptured += chunkSize;
+
+            if (!m_compressZeroPages) {
+                out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(chunkSize));
+                continue;
+            }
+
+            for (size_t page = 0; page < chunkSize; page += Snapshot::PAGE_SIZE) {
+                size_t pageSize = std::min<size_t>(Snapshot::PAGE_SIZE, chunkSize - page);
+                if (isZeroPage(buffer.data() + page, pageSize)) {
+                    pageTables[index].push_back(0);
+                    ++m_zeroPages;
+                } else {
+                    pageTables[index].push_back(static_cast<uint64_t>(out.tellp()));
+                    out.write(reinterpret_cast<const char*>(buffer.data() + page), static_cast<std::streamsize>(pageSize));
+                }
+            }
+        }
+    }
+
+    if (m_compressZeroPages) {
+        padTo(out, sizeof(uint64_t));
+        for (size_t index = 0; index < regions.size() && out; ++index) {
+            table[index].payloadOffset = static_cast<uint64_t>(out.tellp());
+            out.write(reinterpret_cast<const char*>(pageTables[index].data()),
+                static_cast<std::streamsize>(pageTables[index].size() * sizeof(uint64_t)));
+        }
+    }
+
+    m_bytesWritten = static_cast<uint64_t>(out.tellp());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SnapshotRegion)));
+    out.close();
+
+    if (!out) {
+        m_lastError = "Failed writing " + path;
+        return false;
+    }
+
+    m_regionCount = regions.size();
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Project includes
+#include "snapshotformat.h"
+#include "../processmemory.h"
+
+// Records the regions of a process into a snapshot file that
+// SnapshotProcessMemory can serve later. Pages that can't be read while
+// capturing are stored as zeros
+class SnapshotWriter
+{
+public:
+    using RegionFilter = std::function<bool(const MemoryRegion& region)>;
+
+    explicit SnapshotWriter(const IProcessMemory& process);
+
+    // Drops all-zero pages from the file; on by default
+    void setCompressZeroPages(bool enabled) { m_compressZeroPages = enabled; }
+    // Defaults to every readable region
+    void setRegionFilter(RegionFilter filter) { m_filter = std::move(filter); }
+    void setModuleMD5(const std::string& md5) { m_moduleMD5 = md5; }
+
+    bool write(const std::string& path);
+
+    size_t getRegionCount() const { return m_regionCount; }
+    uint64_t getBytesCaptured() const { return m_bytesCaptured; }
+    uint64_t getBytesWritten() const { return m_bytesWritten; }
+    uint64_t getZeroPages() const { return m_zeroPages; }
+    uint64_t getUnreadablePages() const { return m_unreadablePages; }
+    std::string getLastError() const { return m_lastError; }
+
+private:
+    void readFully(uintptr_t address, uint8_t* buffer, size_t size);
+
+    const IProcessMemory& m_process;
+    bool m_compressZeroPages;
+    RegionFilter m_filter;
+    std::string m_moduleMD5;
+
+    size_t m_regionCount;
+    uint64_t m_bytesCaptured;
+    uint64_t m_bytesWritten;
+    uint64_t m_zeroPages;
+    uint64_t m_unreadablePages;
+    std::string m_lastError;
+};
+
+#endif // SNAPSHOTWRITER_H
@@ -1,19 +1,22 @@
 #include "processmanager.h"
 
+// STL includes
+#include <cstdio>
+
 #pragma comment(lib, "version.lib")
 
-DWORD ProcessManager::getProcessId(const QString& processName)
+DWORD ProcessManager::getProcessId(const std::string& processName)
 {
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (snapshot == INVALID_HANDLE_VALUE) {
-        qDebug() << "[ERROR] Failed to create process snapshot";
+        std::fprintf(stderr, "[ERROR] Failed to create process snapshot\n");
         return 0;
     }
 
     PROCESSENTRY32W entry = { sizeof(PROCESSENTRY32W) };
     DWORD pid = 0;
 
-    std::wstring wideProcessName = processName.toStdWString();
+    std::wstring wideProcessName = toWide(processName);
 
     if (Process32FirstW(snapshot, &entry)) {
         do {
@@ -28,7 +31,7 @@ DWORD ProcessManager::getProcessId(const QString& processName)
     return pid;
 }
 
-ProcessHandle ProcessManager::openProcess(const QString& processName, DWORD accessRights)
+ProcessHandle ProcessManager::openProcess(const std::string& processName, DWORD accessRights)
 {
     DWORD pid = getProcessId(processName);
     if (pid == 0) {
@@ -37,11 +40,12 @@ ProcessHandle ProcessManager::openProcess(const QString& processName, DWORD acce
 
     HANDLE handle = OpenProcess(accessRights, FALSE, pid);
     if (!handle) {
-        qDebug() << "[ERROR] Failed to open process" << processName << "PID:" << pid << "Error:" << GetLastError();
+        std::fprintf(stderr, "[ERROR] Failed to open process %s PID: %lu Error: %lu\n", processName.c_str(),
+                     static_cast<unsigned long>(pid), static_cast<unsigned long>(GetLastError()));
         return ProcessHandle();
     }
 
-    qDebug() << "[LOG] Successfully opened process" << processName << "with handle:" << handle;
+    std::fprintf(stderr, "[LOG] Successfully opened process %s with handle: %p\n", processName.c_str(), handle);
     return ProcessHandle(handle);
 }
 
@@ -53,7 +57,8 @@ bool ProcessManager::isProcessRunning(HANDLE processHandle)
 
     DWORD exitCode;
     if (!GetExitCodeProcess(processHandle, &exitCode)) {
-        qDebug() << "[ERROR] Failed to get process exit code, error:" << GetLastError();
+        std::fprintf(stderr, "[ERROR] Failed to get process exit code, error: %lu\n",
+                     static_cast<unsigned long>(GetLastError()));
         return false;
     }
 
@@ -87,7 +92,8 @@ bool ProcessManager::writeMemory(HANDLE process, uintptr_t address, const void*
         buffer, size, &bytesWritten);
 
     if (!success) {
-        qDebug() << "[ERROR] Failed to write memory at address" << Qt::hex << address << "Error:" << GetLastError();
+        std::fprintf(stderr, "[ERROR] Failed to write memory at address %llx Error: %lu\n",
+                     static_cast<unsigned long long>(address), static_cast<unsigned long>(GetLastError()));
         return false;
     }
 
@@ -103,30 +109,28 @@ void ProcessManager::getSystemMemoryLimits(uint8_t*& minAddress, uint8_t*& maxAd
     maxAddress = static_cast<uint8_t*>(sysInfo.lpMaximumApplicationAddress);
 }
 
-QString ProcessManager::computeProcessMD5(DWORD pid) {
-    if (pid == 0) return QString();
-
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
-    if (!hProcess) return QString();
-
-    HMODULE hMod;
-    DWORD cbNeeded;
-    QString hashResult;
-
-    if (EnumProcessModules(hProcess, &hMod, sizeof(hMod), &cbNeeded)) {
-        wchar_t modulePath[MAX_PATH];
-        if (GetModuleFileNameExW(hProcess, hMod, modulePath, MAX_PATH)) {
-            QFile file(QString::fromWCharArray(modulePath));
-            if (file.open(QIODevice::ReadOnly)) {
-                QCryptographicHash hash(QCryptographicHash::Md5);
-                if (hash.addData(&file)) {
-                    hashResult = hash.result().toHex();
-                }
-                file.close();
-            }
-        }
+std::wstring ProcessManager::toWide(const std::string& text)
+{
+    if (text.empty()) {
+        return std::wstring();
+    }
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring wide(static_cast<size_t>(length), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), length);
+    return wide;
+}
+
+std::string ProcessManager::toUtf8(const wchar_t* text)
+{
+    // The length includes the terminator, which the string doesn't keep
+    int length = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+    if (length <= 1) {
+        return std::string();
     }
 
-    CloseHandle(hProcess);
-    return hashResult;
+    std::string utf8(static_cast<size_t>(length), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text, -1, utf8.data(), length, nullptr, nullptr);
+    utf8.resize(static_cast<size_t>(length - 1));
+    return utf8;
 }
@@ -1,11 +1,10 @@
 #ifndef PROCESSMANAGER_H
 #define PROCESSMANAGER_H
 
-// Qt includes
-#include <QString>
-#include <QCryptographicHash>
-#include <QFile>
-#include <QDebug>
+// STL includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
 
 // System includes
 #include <windows.h>
@@ -53,13 +52,15 @@ private:
 class ProcessManager
 {
 public:
-    static DWORD getProcessId(const QString& processName);
-    static ProcessHandle openProcess(const QString& processName, DWORD accessRights);
+    // Names and paths are UTF-8
+    static DWORD getProcessId(const std::string& processName);
+    static ProcessHandle openProcess(const std::string& processName, DWORD accessRights);
     static bool isProcessRunning(HANDLE processHandle);
     static bool readMemory(HANDLE process, uintptr_t address, void* buffer, size_t size);
     static bool writeMemory(HANDLE process, uintptr_t address, const void* buffer, size_t size);
     static void getSystemMemoryLimits(uint8_t*& minAddress, uint8_t*& maxAddress);
-    static QString computeProcessMD5(DWORD pid);
+    static std::wstring toWide(const std::string& text);
+    static std::string toUtf8(const wchar_t* text);
 
 private:
     ProcessManager() = delete;
@@ -0,0 +1,173 @@
+#include "windowsprocessmemory.h"
+
+// STL includes
+#include <cstdio>
+
+uint32_t IProcessMemory::findProcessId(const std::string& processName)
+{
+    return ProcessManager::getProcessId(processName);
+}
+
+std::unique_ptr<IProcessMemory> IProcessMemory::open(uint32_t processId)
+{
+    if (processId == 0) {
+        return nullptr;
+    }
+
+    HANDLE handle = OpenProcess(PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION | PROCESS_QUERY_INFORMATION |
+        SYNCHRONIZE, FALSE, processId);
+    if (!handle) {
+        std::fprintf(stderr, "[ERROR] Failed to open process PID: %u Error: %lu\n", processId,
+                     static_cast<unsigned long>(GetLastError()));
+        return nullptr;
+    }
+
+    std::fprintf(stderr, "[LOG] Successfully opened process %u with handle: %p\n", processId, handle);
+    return std::make_unique<WindowsProcessMemory>(processId, ProcessHandle(handle));
+}
+
+WindowsProcessMemory::WindowsProcessMemory(DWORD processId, ProcessHandle handle)
+    : m_processId(processId)
+    , m_handle(std::move(handle))
+    , m_interruptEvent(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+{
+}
+
+WindowsProcessMemory::~WindowsProcessMemory()
+{
+    if (m_interruptEvent) {
+        CloseHandle(m_interruptEvent);
+    }
+}
+
+bool WindowsProcessMemory::isAlive() const
+{
+    // Signalled once the process exits; unlike the exit code this can't be
+    // confused with a process that returned STILL_ACTIVE
+    return m_handle.get() && WaitForSingleObject(m_handle.get(), 0) == WAIT_TIMEOUT;
+}
+
+std::string WindowsProcessMemory::modulePath() const
+{
+    HMODULE module;
+    DWORD bytesNeeded;
+    if (!EnumProcessModules(m_handle.get(), &module, sizeof(module), &bytesNeeded)) {
+        return std::string();
+    }
+
+    wchar_t path[MAX_PATH];
+    if (!GetModuleFileNameExW(m_handle.get(), module, path, MAX_PATH)) {
+        return std::string();
+    }
+
+    return ProcessManager::toUtf8(path);
+}
+
+std::vector<MemoryRegion> WindowsProcessMemory::enumerateRegions() const
+{
+    std::vector<MemoryRegion> regions;
+
+    uint8_t* memStart = nullptr;
+    uint8_t* memEnd = nullptr;
+    ProcessManager::getSystemMemoryLimits(memStart, memEnd);
+
+    MEMORY_BASIC_INFORMATION memInfo;
+    uint8_t* address = memStart;
+
+    while (address < memEnd && VirtualQueryEx(m_handle.get(), address, &memInfo, sizeof(memInfo))) {
+        if (memInfo.State == MEM_COMMIT) {
+            regions.push_back({reinterpret_cast<uintptr_t>(memInfo.BaseAddress), memInfo.RegionSize,
+                toProtection(memInfo.Protect), toRegionType(memInfo.Type)});
+        }
+        address = static_cast<uint8_t*>(memInfo.BaseAddress) + memInfo.RegionSize;
+    }
+
+    return regions;
+}
+
+size_t WindowsProcessMemory::read(uintptr_t address, void* buffer, size_t size) const
+{
+    SIZE_T bytesRead = 0;
+    countSyscalls();
+    if (!ReadProcessMemory(m_handle.get(), reinterpret_cast<LPCVOID>(address), buffer, size, &bytesRead)) {
+        // Partial copies report ERROR_PARTIAL_COPY but still fill bytesRead
+        return (GetLastError() == ERROR_PARTIAL_COPY) ? bytesRead : 0;
+    }
+    return bytesRead;
+}
+
+bool WindowsProcessMemory::write(uintptr_t address, const void* buffer, size_t size) const
+{
+    countSyscalls();
+    return ProcessManager::writeMemory(m_handle.get(), address, buffer, size);
+}
+
+bool WindowsProcessMemory::waitForExit(int timeoutMs) const
+{
+    if (!m_interruptEvent) {
+        return IProcessMemory::waitForExit(timeoutMs);
+    }
+
+    // The process handle is signaled when the process exits
+    HANDLE handles[2] = {m_handle.get(), m_interruptEvent};
+    DWORD result = WaitForMultipleObjects(2, handles, FALSE, static_cast<DWORD>(timeoutMs));
+    return result == WAIT_OBJECT_0;
+}
+
+void WindowsProcessMemory::interruptWait() const
+{
+    if (!m_interruptEvent) {
+        IProcessMemory::interruptWait();
+        return;
+    }
+    SetEvent(m_interruptEvent);
+}
+
+uint32_t WindowsProcessMemory::toProtection(DWORD protect)
+{
+    uint32_t protection = 0;
+
+    switch (protect & 0xFF) {
+        case PAGE_READONLY:
+            protection = MemoryProtection::READ;
+            break;
+        case PAGE_READWRITE:
+            protection = MemoryProtection::READ | MemoryProtection::WRITE;
+            break;
+        case PAGE_WRITECOPY:
+            protection = MemoryProtection::READ | MemoryProtection::WRITE | MemoryProtection::COPY_ON_WRITE;
+            break;
+        case PAGE_EXECUTE:
+            protection = MemoryProtection::EXECUTE;
+            break;
+        case PAGE_EXECUTE_READ:
+            protection = MemoryProtection::READ | MemoryProtection::EXECUTE;
+            break;
+        case PAGE_EXECUTE_READWRITE:
+            protection = MemoryProtection::READ | MemoryProtection::WRITE | MemoryProtection::EXECUTE;
+            break;
+        case PAGE_EXECUTE_WRITECOPY:
+            protection = MemoryProtection::READ | MemoryProtection::WRITE | MemoryProtection::EXECUTE |
+                MemoryProtection::COPY_ON_WRITE;
+            break;
+        default:
+            break;
+    }
+
+    if (protect & PAGE_GUARD) {
+        protection |= MemoryProtection::GUARD;
+    }
+    return protection;
+}
+
+RegionType WindowsProcessMemory::toRegionType(DWORD type)
+{
+    switch (type) {
+        case MEM_IMAGE:
+            return RegionType::Image;
+        case MEM_MAPPED:
+            return RegionType::Mapped;
+        default:
+            return RegionType::Private;
+    }
+}
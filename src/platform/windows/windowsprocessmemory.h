@@ -0,0 +1,36 @@
+#ifndef WINDOWSPROCESSMEMORY_H
+#define WINDOWSPROCESSMEMORY_H
+
+// Project includes
+#include "../processmemory.h"
+#include "processmanager.h"
+
+// ReadProcessMemory has no scatter-gather form, so batches use the default
+// one call per span
+class WindowsProcessMemory : public IProcessMemory
+{
+public:
+    WindowsProcessMemory(DWORD processId, ProcessHandle handle);
+    ~WindowsProcessMemory() override;
+
+    uint32_t processId() const override { return m_processId; }
+    bool isAlive() const override;
+    std::string modulePath() const override;
+    std::vector<MemoryRegion> enumerateRegions() const override;
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    bool write(uintptr_t address, const void* buffer, size_t size) const override;
+    bool waitForExit(int timeoutMs) const override;
+    void interruptWait() const override;
+
+    HANDLE handle() const { return m_handle.get(); }
+
+private:
+    static uint32_t toProtection(DWORD protect);
+    static RegionType toRegionType(DWORD type);
+
+    DWORD m_processId;
+    ProcessHandle m_handle;
+    HANDLE m_interruptEvent;
+};
+
+#endif // WINDOWSPROCESSMEMORY_H
@@ -0,0 +1,200 @@
+// StreamSearcher boundary test: every built-in signature is planted in a
+// random buffer, which is then delivered in two pieces split at each
+// offset across the pattern and in equal pieces of every size up to the
+// pattern's, so matches straddle piece boundaries in every possible way.
+// Also checks that reset() after a short read drops the carried tail.
+// Exits non-zero if any check fails
+//
+//   ctest --test-dir build --output-on-failure
+
+// STL includes
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Project includes
+#include "../core/builtinsignatures.h"
+#include "../core/multipatternmatcher.h"
+#include "../core/patternmatcher.h"
+#include "../core/streamsearcher.h"
+
+namespace {
+
+constexpr size_t BUFFER_SIZE = 4096;
+constexpr size_t PLANT_OFFSET = 1500;
+constexpr uint64_t STREAM_BASE = 0x7ff600000000;
+
+int g_failures = 0;
+
+void fail(const char* what, size_t signature, size_t detail, uint64_t got, uint64_t expected)
+{
+    std::fprintf(stderr, "[ERROR] %s | signature %zu (%s) | at %zu | got %llx, expected %llx\n", what, signature,
+                 BuiltinSignatures::name(signature), detail, static_cast<unsigned long long>(got),
+                 static_cast<unsigned long long>(expected));
+    ++g_failures;
+}
+
+// Deterministic xorshift, so every run tests the same bytes
+uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Random bytes with the pattern written at offset; wildcard positions keep
+// their random byte
+std::vector<uint8_t> plantedBuffer(const BytePattern& pattern, size_t offset, uint64_t seed)
+{
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    uint64_t state = seed;
+    for (uint8_t& byte : buffer) {
+        byte = static_cast<uint8_t>(nextRandom(state));
+    }
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern.isFixed(i)) {
+            buffer[offset + i] = pattern.values()[i];
+        }
+    }
+    return buffer;
+}
+
+template <typename Matcher>
+StreamMatch feedSplit(StreamSearcher<Matcher>& searcher, const std::vector<uint8_t>& buffer, size_t split)
+{
+    searcher.reset(STREAM_BASE);
+    StreamMatch match = searcher.feed(buffer.data(), split);
+    if (!match.found()) {
+        match = searcher.feed(buffer.data() + split, buffer.size() - split);
+    }
+    return match;
+}
+
+template <typename Matcher>
+StreamMatch feedPieces(StreamSearcher<Matcher>& searcher, const std::vector<uint8_t>& buffer, size_t piece)
+{
+    searcher.reset(STREAM_BASE);
+    for (size_t offset = 0; offset < buffer.size(); offset += piece) {
+        const size_t size = (buffer.size() - offset < piece) ? buffer.size() - offset : piece;
+        StreamMatch match = searcher.feed(buffer.data() + offset, size);
+        if (match.found()) {
+            return match;
+        }
+    }
+    return {UINT64_MAX, SIZE_MAX};
+}
+
+// Splits at every offset from just before the pattern to just after it,
+// then feeds equal pieces of 1 to size bytes
+template <typename Matcher>
+void checkBoundaries(const char* label, StreamSearcher<Matcher>& searcher, const std::vector<uint8_t>& buffer,
+                     size_t signature, size_t patternSize, size_t expectedIndex)
+{
+    const uint64_t expected = STREAM_BASE + PLANT_OFFSET;
+
+    for (size_t split = PLANT_OFFSET; split <= PLANT_OFFSET + patternSize; ++split) {
+        StreamMatch match = feedSplit(searcher, buffer, split);
+        if (match.position != expected) {
+            fail(label, signature, split, match.position, expected);
+        } else if (match.patternIndex != expectedIndex) {
+            fail(label, signature, split, match.patternIndex, expectedIndex);
+        }
+    }
+
+    for (size_t piece = 1; piece <= patternSize; ++piece) {
+        StreamMatch match = feedPieces(searcher, buffer, piece);
+        if (match.position != expected) {
+            fail(label, signature, piece, match.position, expected);
+        }
+    }
+}
+
+// A short read that ends with the start of the pattern, then reset() for
+// the next region: the carried bytes must not complete a match with the
+// new region's first bytes
+template <typename Matcher>
+void checkResetAfterShortRead(const char* label, StreamSearcher<Matcher>& searcher, const BytePattern& pattern,
+                              const std::vector<uint8_t>& buffer, size_t signature)
+{
+    const size_t head = pattern.size() / 2;
+    const uint8_t* planted = buffer.data() + PLANT_OFFSET;
+
+    searcher.reset(STREAM_BASE);
+    searcher.feed(planted, head);
+
+    const uint64_t nextBase = STREAM_BASE + 0x100000;
+    searcher.reset(nextBase);
+    StreamMatch match = searcher.feed(planted + head, pattern.size() - head);
+    if (match.found()) {
+        fail(label, signature, head, match.position, UINT64_MAX);
+    }
+
+    // The searcher still works, and counts from the new base
+    match = searcher.feed(buffer.data(), buffer.size());
+    const uint64_t expected = nextBase + (pattern.size() - head) + PLANT_OFFSET;
+    if (match.position != expected) {
+        fail(label, signature, head, match.position, expected);
+    }
+}
+
+// The planted copy must be the only match, or positions can't be compared
+bool isOnlyMatch(const BytePattern& pattern, const std::vector<uint8_t>& buffer, size_t offset)
+{
+    for (size_t i = 0; i + pattern.size() <= buffer.size(); ++i) {
+        if (i != offset && pattern.matchesAt(buffer.data() + i)) {
+            return false;
+        }
+    }
+    return pattern.matchesAt(buffer.data() + offset);
+}
+
+} // namespace
+
+int main()
+{
+    const size_t count = BuiltinSignatures::count();
+    if (count == 0) {
+        std::fprintf(stderr, "[ERROR] No built-in signatures to test\n");
+        return 1;
+    }
+
+    std::vector<PatternMatcher> matchers;
+    for (size_t i = 0; i < count; ++i) {
+        matchers.emplace_back(BuiltinSignatures::pattern(i));
+        matchers.back().setCompare(BuiltinSignatures::compare(i));
+    }
+    const MultiPatternMatcher multiMatcher(matchers);
+
+    for (size_t i = 0; i < count; ++i) {
+        const BytePattern& pattern = BuiltinSignatures::pattern(i);
+        const std::vector<uint8_t> buffer = plantedBuffer(pattern, PLANT_OFFSET, 0x9e3779b97f4a7c15ULL + i);
+        if (!isOnlyMatch(pattern, buffer, PLANT_OFFSET)) {
+            fail("planted pattern isn't unique", i, PLANT_OFFSET, 0, 0);
+            continue;
+        }
+
+        StreamSearcher<PatternMatcher> single(matchers[i]);
+        checkBoundaries("single", single, buffer, i, pattern.size(), 0);
+        checkResetAfterShortRead("single reset", single, pattern, buffer, i);
+
+        // Another signature may match at the same spot; the stream must
+        // agree with a search of the whole buffer
+        const MultiPatternMatcher::Match whole = multiMatcher.search(buffer.data(), buffer.size());
+        if (whole.offset != PLANT_OFFSET) {
+            fail("multi whole buffer", i, PLANT_OFFSET, whole.offset, PLANT_OFFSET);
+            continue;
+        }
+        StreamSearcher<MultiPatternMatcher> multi(multiMatcher);
+        checkBoundaries("multi", multi, buffer, i, pattern.size(), whole.patternIndex);
+        checkResetAfterShortRead("multi reset", multi, pattern, buffer, i);
+    }
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "[ERROR] %d StreamSearcher checks failed\n", g_failures);
+        return 1;
+    }
+
+    std::printf("[LOG] StreamSearcher boundaries hold for %zu signatures\n", count);
+    return 0;
+}
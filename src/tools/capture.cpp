@@ -0,0 +1,76 @@
+// Records the memory of a running game into a snapshot file, so scans can
+// be replayed offline with SnapshotProcessMemory:
+//
+//   bba_capture -o v49.bbasnap              (finds beatbanger.exe)
+//   bba_capture -p 1234 -o heap.bbasnap --scan-regions-only
+
+// Qt includes
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Project includes
+#include "../core/regionscanner.h"
+#include "../platform/processmemory.h"
+#include "../platform/snapshot/snapshotwriter.h"
+#include "../utils/constants.h"
+#include "../utils/fingerprintcache.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bba_capture");
+    QCoreApplication::setApplicationVersion(Constants::APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Captures the game's memory into a snapshot file");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption outputOption({"o", "output"}, "Snapshot file to write", "file");
+    QCommandLineOption pidOption({"p", "pid"}, "Process ID to capture", "pid");
+    QCommandLineOption nameOption({"n", "name"}, "Process name to look up", "name", Constants::GAME_PROCESS_NAME);
+    QCommandLineOption rawOption("no-compress", "Store all-zero pages instead of dropping them");
+    QCommandLineOption scanOnlyOption("scan-regions-only", "Only capture writable or executable regions, like the scanner");
+    parser.addOptions({outputOption, pidOption, nameOption, rawOption, scanOnlyOption});
+    parser.process(app);
+
+    if (!parser.isSet(outputOption)) {
+        qCritical() << "[ERROR] No output file given";
+        parser.showHelp(1);
+    }
+
+    uint32_t pid = parser.isSet(pidOption)
+        ? parser.value(pidOption).toUInt()
+        : IProcessMemory::findProcessId(parser.value(nameOption).toStdString());
+
+    auto process = IProcessMemory::open(pid);
+    if (!process) {
+        qCritical() << "[ERROR] Couldn't open process" << (pid ? QString::number(pid) : parser.value(nameOption));
+        return 1;
+    }
+
+    SnapshotWriter writer(*process);
+    writer.setCompressZeroPages(!parser.isSet(rawOption));
+    writer.setModuleMD5(FingerprintCache::hashFile(QString::fromStdString(process->modulePath())).toStdString());
+    if (parser.isSet(scanOnlyOption)) {
+        writer.setRegionFilter(&RegionScanner::isScannable);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!writer.write(parser.value(outputOption).toStdString())) {
+        qCritical() << "[ERROR]" << QString::fromStdString(writer.getLastError());
+        return 1;
+    }
+
+    qInfo() << "[LOG] Captured" << writer.getRegionCount() << "regions |"
+            << writer.getBytesCaptured() / (1024 * 1024) << "MB read |"
+            << writer.getBytesWritten() / (1024 * 1024) << "MB written |"
+            << writer.getZeroPages() << "zero pages |"
+            << writer.getUnreadablePages() << "unreadable pages |"
+            << timer.elapsed() << "ms";
+    return 0;
+}
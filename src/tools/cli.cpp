@@ -0,0 +1,352 @@
+// Runs the scanner without the GUI, for scripts, batch runs and profiling.
+// Phases run one after another so each gets its own timing, and the scan
+// always covers every region instead of trying the address cache first:
+//
+//   bba_cli                                   (finds beatbanger.exe, scans)
+//   bba_cli --snapshot v49.bbasnap --json     (offline scan, JSON report)
+//   bba_cli --autoplay --autoplay-seconds 60  (scan, then drive autoplay)
+
+// Qt includes
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Project includes
+#include "../core/autoplayengine.h"
+#include "../core/cancellationtoken.h"
+#include "../core/multipatternmatcher.h"
+#include "../core/patternmatcher.h"
+#include "../core/regionclassifier.h"
+#include "../core/regionscanner.h"
+#include "../core/scanthreadpool.h"
+#include "../platform/processmemory.h"
+#include "../platform/snapshot/snapshotprocessmemory.h"
+#include "../utils/configmanager.h"
+#include "../utils/constants.h"
+#include "../utils/fingerprintcache.h"
+#include "../utils/latencyhistogramjson.h"
+
+namespace {
+
+// 0 when the flag was found, 1 on errors
+constexpr int EXIT_NOT_FOUND = 2;
+
+CancellationToken g_interrupt;
+
+void onInterrupt(int)
+{
+    g_interrupt.cancel();
+}
+
+QString hexAddress(uintptr_t address)
+{
+    return "0x" + QString::number(static_cast<quint64>(address), 16);
+}
+
+// Wall time of each phase, in the order they ran
+class PhaseTimer
+{
+public:
+    PhaseTimer() { m_total.start(); }
+
+    void begin() { m_phase.start(); }
+    void end(const QString& name) { m_phases.append(qMakePair(name, m_phase.nsecsElapsed() / 1000000.0)); }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject obj;
+        for (const auto& phase : m_phases) {
+            obj[phase.first + "_ms"] = phase.second;
+        }
+        obj["total_ms"] = m_total.nsecsElapsed() / 1000000.0;
+        return obj;
+    }
+
+private:
+    QElapsedTimer m_total;
+    QElapsedTimer m_phase;
+    QList<QPair<QString, double>> m_phases;
+};
+
+// Human-readable form of the report, one "key: value" per line
+void printReport(QTextStream& out, const QJsonObject& obj, const QString& indent = QString())
+{
+    for (auto it = obj.begin(); it != obj.end(); ++it) {
+        if (it.value().isObject()) {
+            out << indent << it.key() << ":\n";
+            printReport(out, it.value().toObject(), indent + "  ");
+        } else {
+            out << indent << it.key() << ": " << it.value().toVariant().toString() << "\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bba_cli");
+    QCoreApplication::setApplicationVersion(Constants::APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Finds the autoplay flag without the GUI and reports per-phase timings");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption snapshotOption("snapshot", "Scan a recorded snapshot instead of the running game", "file");
+    QCommandLineOption pidOption({"p", "pid"}, "Process ID to scan", "pid");
+    QCommandLineOption nameOption({"n", "name"}, "Process name to look up", "name", Constants::GAME_PROCESS_NAME);
+    QCommandLineOption configOption({"c", "config"}, "config.json to load", "file");
+    QCommandLineOption workersOption("workers", "Scan worker threads, 0 for one per core", "count", "0");
+    QCommandLineOption depthOption("pipeline-depth", "Chunk buffers in flight per worker, below 2 to disable",
+                                   "count", QString::number(Constants::SCAN_PIPELINE_DEPTH));
+    QCommandLineOption coldOption("cold", "Hash the executable even when its fingerprint is cached");
+    QCommandLineOption autoplayOption("autoplay", "Drive autoplay after a successful scan");
+    QCommandLineOption secondsOption("autoplay-seconds", "Stop autoplay after this many seconds, 0 to run until "
+                                     "the game exits or Ctrl+C", "seconds", "0");
+    QCommandLineOption jsonOption("json", "Print the report as JSON");
+    parser.addOptions({snapshotOption, pidOption, nameOption, configOption, workersOption, depthOption,
+                       coldOption, autoplayOption, secondsOption, jsonOption});
+    parser.process(app);
+
+    if (parser.isSet(snapshotOption) && parser.isSet(autoplayOption)) {
+        qCritical() << "[ERROR] Snapshots are read-only, autoplay needs the running game";
+        return 1;
+    }
+
+    QJsonObject report;
+    PhaseTimer phases;
+
+    // Attach
+    phases.begin();
+    std::unique_ptr<IProcessMemory> process;
+    if (parser.isSet(snapshotOption)) {
+        std::string error;
+        process = SnapshotProcessMemory::open(parser.value(snapshotOption).toStdString(), error);
+        if (!process) {
+            qCritical() << "[ERROR] Failed to open snapshot:" << QString::fromStdString(error);
+            return 1;
+        }
+        report["target"] = parser.value(snapshotOption);
+    } else {
+        uint32_t pid = parser.isSet(pidOption)
+            ? parser.value(pidOption).toUInt()
+            : IProcessMemory::findProcessId(parser.value(nameOption).toStdString());
+        process = pid ? IProcessMemory::open(pid) : nullptr;
+        if (!process) {
+            qCritical() << "[ERROR] Couldn't open process" << (pid ? QString::number(pid) : parser.value(nameOption));
+            return 1;
+        }
+        report["target"] = QString::fromStdString(process->modulePath());
+    }
+    report["pid"] = static_cast<qint64>(process->processId());
+    phases.end("attach");
+
+    // Config
+    phases.begin();
+    const QString configPath = parser.isSet(configOption)
+        ? parser.value(configOption)
+        : QDir(QCoreApplication::applicationDirPath()).filePath(Constants::CONFIG_FILENAME);
+    ConfigManager config;
+    if (!config.loadFromFile(configPath)) {
+        qCritical() << "[ERROR] Failed to load" << configPath << ":" << config.getLastError();
+        return 1;
+    }
+    phases.end("config");
+
+    // Fingerprint
+    phases.begin();
+    // Snapshots carry the hash of the build they were taken from
+    QString md5 = QString::fromStdString(process->moduleMD5());
+    QString fingerprintSource = "snapshot";
+    if (md5.isEmpty()) {
+        const QString modulePath = QString::fromStdString(process->modulePath());
+        fingerprintSource = "hashed";
+        if (parser.isSet(coldOption)) {
+            md5 = FingerprintCache::hashFile(modulePath);
+        } else {
+            FingerprintCache fingerprints;
+            if (!fingerprints.loadFromFile(QDir(QCoreApplication::applicationDirPath()).filePath(Constants::FINGERPRINT_CACHE_FILENAME))) {
+                qDebug() << "[WARNING] Fingerprint cache ignored:" << fingerprints.getLastError();
+            }
+            md5 = fingerprints.fingerprint(modulePath);
+            if (fingerprints.getHits() > 0) {
+                fingerprintSource = "cache";
+            }
+        }
+    }
+    if (md5.isEmpty()) {
+        qCritical() << "[ERROR] Failed to get the game version";
+        return 1;
+    }
+    phases.end("fingerprint");
+
+    // Known builds look for their own signature; unknown ones for every
+    // signature, newest first, taking the layout from the hit
+    std::optional<VersionConfig> known = config.getVersionConfig(md5);
+    std::vector<VersionConfig> scanConfigs;
+    if (known.has_value()) {
+        scanConfigs.push_back(known.value());
+    } else {
+        const QList<VersionConfig>& configurations = config.getConfigurations();
+        scanConfigs.assign(configurations.rbegin(), configurations.rend());
+    }
+    if (scanConfigs.empty()) {
+        qCritical() << "[ERROR] Version isn't supported: unknown MD5" << md5 << "and no configurations to detect it";
+        return 1;
+    }
+
+    QJsonObject version;
+    version["md5"] = md5;
+    version["fingerprint_source"] = fingerprintSource;
+    version["known"] = known.has_value();
+
+    // Regions
+    phases.begin();
+    const std::vector<MemoryRegion> regions = RegionScanner::scannableRegions(process->enumerateRegions());
+    phases.end("regions");
+
+    // Scan
+    phases.begin();
+    std::vector<PatternMatcher> matchers;
+    for (const VersionConfig& scanConfig : scanConfigs) {
+        matchers.push_back(scanConfig.matcher ? *scanConfig.matcher : PatternMatcher(scanConfig.autoplayPattern));
+    }
+    MultiPatternMatcher matcher(matchers);
+
+    RegionHints hints = scanConfigs.front().regionHints;
+    for (size_t i = 1; i < scanConfigs.size(); ++i) {
+        hints = RegionClassifier::combine(hints, scanConfigs[i].regionHints);
+    }
+    const std::vector<MemoryRegion> prioritized = RegionClassifier::prioritize(regions, hints);
+
+    RegionScanOptions options;
+    options.workerCount = parser.value(workersOption).toUInt();
+    options.pipelineDepth = parser.value(depthOption).toUInt();
+    ScanThreadPool threads;
+    RegionScanner scanner(*process, options, nullptr, &threads);
+
+    // Ctrl+C from here on ends the scan or autoplay and still reports
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+
+    RegionMatch result;
+    const bool found = scanner.scan(prioritized, matcher, g_interrupt, result);
+    phases.end("scan");
+
+    const RegionScanStats& stats = scanner.getStats();
+    QJsonObject scan;
+    scan["found"] = found;
+    scan["regions"] = static_cast<qint64>(prioritized.size());
+    scan["regions_skipped"] = static_cast<qint64>(regions.size() - prioritized.size());
+    scan["work_items"] = static_cast<qint64>(stats.itemCount);
+    scan["workers"] = static_cast<qint64>(stats.workers.size());
+    scan["pipeline_depth"] = static_cast<qint64>(options.pipelineDepth);
+    scan["bytes_scanned"] = static_cast<qint64>(stats.bytesScanned);
+    scan["bytes_before_hit"] = static_cast<qint64>(stats.bytesBeforeHit);
+    scan["read_syscalls"] = static_cast<qint64>(stats.syscalls);
+    scan["pipeline_stalls"] = static_cast<qint64>(stats.stalls);
+    scan["page_faults"] = static_cast<qint64>(stats.pageFaults);
+    scan["peak_rss"] = static_cast<qint64>(stats.peakRss);
+    scan["buffer_bytes"] = static_cast<qint64>(stats.buffers.bytesHeld);
+    scan["large_page_buffers"] = static_cast<qint64>(stats.buffers.largePageBuffers);
+    scan["threads_started"] = static_cast<qint64>(stats.threadsStarted);
+    scan["patterns"] = static_cast<qint64>(scanConfigs.size());
+    scan["search_kernel"] = PatternMatcher::kernelName(PatternMatcher::activeKernel());
+
+    AutoplayAddresses addresses = {0, 0, 0};
+    VersionConfig layout;
+    if (found) {
+        layout = scanConfigs[result.patternIndex];
+        addresses = {
+            result.address,
+            result.address - layout.isPlayingOffset,
+            result.address - layout.timeOffset
+        };
+
+        QJsonObject addressObj;
+        addressObj["autoplay"] = hexAddress(addresses.autoplay);
+        addressObj["is_playing"] = hexAddress(addresses.isPlaying);
+        addressObj["time"] = hexAddress(addresses.time);
+        scan["addresses"] = addressObj;
+
+        for (const MemoryRegion& region : prioritized) {
+            if (result.address >= region.base && result.address < region.base + region.size) {
+                scan["hit_class"] = RegionClassifier::className(RegionClassifier::classify(region));
+                break;
+            }
+        }
+        version["layout"] = layout.displayName;
+    }
+
+    report["version"] = version;
+    report["scan"] = scan;
+
+    // Autoplay
+    if (found && parser.isSet(autoplayOption)) {
+        AutoplayMetrics metrics;
+        AutoplayEngine engine(*process, addresses, layout.autoplayRules, metrics);
+
+        // The engine sleeps inside waitForExit(), so a watcher wakes it for
+        // Ctrl+C or the time limit; stop() isn't safe in a signal handler
+        const int seconds = parser.value(secondsOption).toInt();
+        std::atomic<bool> finished(false);
+        std::future<void> watcher = threads.submit([&]() {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+            while (!finished.load()) {
+                if (g_interrupt.isCancelled() || (seconds > 0 && std::chrono::steady_clock::now() >= deadline)) {
+                    engine.stop();
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        });
+
+        qInfo() << "[LOG] Autoplay is active" << (seconds > 0 ? QString("for %1 s").arg(seconds) : QString("until Ctrl+C"));
+        phases.begin();
+        const AutoplayEngine::ExitReason reason = engine.run();
+        phases.end("autoplay");
+
+        finished = true;
+        watcher.wait();
+
+        QJsonObject autoplay;
+        autoplay["exit"] = (reason == AutoplayEngine::ExitReason::ProcessExited) ? "process_exited" : "stopped";
+        autoplay["ticks"] = static_cast<qint64>(metrics.ticks.load());
+        autoplay["writes"] = static_cast<qint64>(metrics.writes.load());
+        autoplay["missed_transitions"] = static_cast<qint64>(metrics.missedTransitions.load());
+        autoplay["late_arms"] = static_cast<qint64>(metrics.lateArms.load());
+        autoplay["read"] = histogramToJson(metrics.readLatency);
+        autoplay["detect_to_write"] = histogramToJson(metrics.detectToWrite);
+        report["autoplay"] = autoplay;
+    }
+
+    report["phases"] = phases.toJson();
+
+    QTextStream out(stdout);
+    if (parser.isSet(jsonOption)) {
+        out << QJsonDocument(report).toJson(QJsonDocument::Indented);
+    } else {
+        printReport(out, report);
+    }
+
+    return found ? 0 : EXIT_NOT_FOUND;
+}
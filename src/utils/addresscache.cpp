@@ -0,0 +1,113 @@
+#include "addresscache.h"
+
+bool AddressCache::loadFromFile(const QString& cachePath)
+{
+    m_cachePath = cachePath;
+    m_entries.clear();
+    m_hits = 0;
+    m_lookups = 0;
+    m_lastError.clear();
+
+    QFile file(cachePath);
+    if (!file.exists()) {
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_lastError = "Couldn't open address cache";
+        return false;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    if (!doc.isObject()) {
+        m_lastError = "Invalid address cache format";
+        return false;
+    }
+
+    QJsonObject rootObj = doc.object();
+    if (rootObj["version"].toInt() != CACHE_FORMAT_VERSION) {
+        qDebug() << "[LOG] Discarding address cache with old format";
+        return true;
+    }
+
+    m_hits = rootObj["hits"].toInt();
+    m_lookups = rootObj["lookups"].toInt();
+
+    QJsonObject entries = rootObj["entries"].toObject();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        QJsonObject entryObj = it.value().toObject();
+        bool ok = true;
+        CachedLocation location;
+        location.regionBase = entryObj["region_base"].toString().toULongLong(&ok, 16);
+        if (!ok) {
+            continue;
+        }
+        location.regionSize = entryObj["region_size"].toString().toULongLong(&ok, 16);
+        if (!ok) {
+            continue;
+        }
+        location.protect = static_cast<uint32_t>(entryObj["protect"].toInteger());
+        location.offset = entryObj["offset"].toString().toULongLong(&ok, 16);
+        if (!ok || location.offset >= location.regionSize) {
+            continue;
+        }
+        m_entries[it.key()] = location;
+    }
+
+    return true;
+}
+
+bool AddressCache::save() const
+{
+    if (m_cachePath.isEmpty()) {
+        return false;
+    }
+
+    QJsonObject entries;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        QJsonObject entryObj;
+        entryObj["region_base"] = QString::number(it.value().regionBase, 16);
+        entryObj["region_size"] = QString::number(it.value().regionSize, 16);
+        entryObj["protect"] = static_cast<qint64>(it.value().protect);
+        entryObj["offset"] = QString::number(it.value().offset, 16);
+        entries[it.key()] = entryObj;
+    }
+
+    QJsonObject rootObj;
+    rootObj["version"] = CACHE_FORMAT_VERSION;
+    rootObj["hits"] = m_hits;
+    rootObj["lookups"] = m_lookups;
+    rootObj["entries"] = entries;
+
+    QSaveFile file(m_cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[ERROR] Could not write address cache";
+        return false;
+    }
+
+    file.write(QJsonDocument(rootObj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+std::optional<CachedLocation> AddressCache::lookup(const QString& md5Hash) const
+{
+    auto it = m_entries.find(md5Hash);
+    if (it != m_entries.end())
+        return it.value();
+    return std::nullopt;
+}
+
+void AddressCache::store(const QString& md5Hash, const CachedLocation& location)
+{
+    m_entries[md5Hash] = location;
+}
+
+void AddressCache::recordLookup(bool hit)
+{
+    ++m_lookups;
+    if (hit) {
+        ++m_hits;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef ADDRESSCACHE_H
+#define ADDRESSCACHE_H
+
+// Qt includes
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QString>
+
+// STL includes
+#include <cstdint>
+#include <optional>
+
+struct CachedLocation {
+    uint64_t regionBase;
+    uint64_t regionSize;
+    uint32_t protect; // MemoryProtection flags
+    uint64_t offset;
+};
+
+// Remembers, per executable MD5, where the autoplay signature was last found
+// so the next scan can verify that spot before walking the whole heap
+class AddressCache
+{
+public:
+    bool loadFromFile(const QString& cachePath);
+    bool save() const;
+
+    std::optional<CachedLocation> lookup(const QString& md5Hash) const;
+    void store(const QString& md5Hash, const CachedLocation& location);
+    void recordLookup(bool hit);
+
+    int getHits() const { return m_hits; }
+    int getLookups() const { return m_lookups; }
+    QString getLastError() const { return m_lastError; }
+
+private:
+    static constexpr int CACHE_FORMAT_VERSION = 2;
+
+    QString m_cachePath;
+    QHash<QString, CachedLocation> m_entries;
+    int m_hits = 0;
+    int m_lookups = 0;
+    QString m_lastError;
+};
+
+#endif // ADDRESSCACHE_H
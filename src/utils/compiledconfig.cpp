@@ -0,0 +1,297 @@
+#include "compiledconfig.h"
+
+// Qt includes
+#include <QMap>
+#include <QSaveFile>
+
+// STL includes
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// Project includes
+#include "configmanager.h"
+#include "constants.h"
+
+static_assert(static_cast<size_t>(RegionClass::Count) <= CompiledConfigFormat::MAX_REGION_CLASSES,
+              "CompiledRegionHints can't hold every region class");
+
+namespace {
+
+class Blob
+{
+public:
+    explicit Blob(QByteArray& data) : m_data(data) {}
+
+    CompiledSpan append(const QByteArray& bytes)
+    {
+        CompiledSpan span = {static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(bytes.size())};
+        m_data.append(bytes);
+        return span;
+    }
+
+    CompiledSpan append(const uint8_t* bytes, size_t size)
+    {
+        return append(QByteArray(reinterpret_cast<const char*>(bytes), static_cast<qsizetype>(size)));
+    }
+
+private:
+    QByteArray& m_data;
+};
+
+} // namespace
+
+bool CompiledConfig::open(const QString& path)
+{
+    m_lastError.clear();
+
+    if (!m_file.open(path.toStdString())) {
+        m_lastError = QString::fromStdString(m_file.getLastError());
+        return false;
+    }
+
+    const uint64_t fileSize = m_file.size();
+    if (fileSize < sizeof(CompiledConfigHeader)) {
+        m_lastError = "Compiled config is truncated";
+        m_file.close();
+        return false;
+    }
+
+    const CompiledConfigHeader* head = header();
+    if (std::memcmp(head->magic, CompiledConfigFormat::MAGIC, sizeof(head->magic)) != 0 ||
+        head->version != CompiledConfigFormat::FORMAT_VERSION) {
+        m_lastError = "Compiled config has another format";
+        m_file.close();
+        return false;
+    }
+
+    const uint64_t recordsEnd = head->recordsOffset + uint64_t(head->configCount) * sizeof(CompiledConfigRecord);
+    const uint64_t indexEnd = head->md5IndexOffset + uint64_t(head->md5Count) * sizeof(CompiledMD5Entry);
+    bool valid = head->recordsOffset >= sizeof(CompiledConfigHeader) && recordsEnd <= fileSize &&
+                 head->md5IndexOffset >= recordsEnd && indexEnd <= fileSize &&
+                 spanValid(head->sourceFileId) && spanValid(head->compilerVersion) &&
+                 spanValid(head->appVersion) && spanValid(head->configVersion);
+
+    for (uint32_t i = 0; valid && i < head->configCount; ++i) {
+        const CompiledConfigRecord& record = records()[i];
+        const uint32_t size = record.valueMask.size;
+        const CompiledRegionHints& hints = record.regionHints;
+        valid = spanValid(record.displayName) && spanValid(record.valueMask) && spanValid(record.careMask) &&
+                size > 0 && record.careMask.size == size &&
+                record.anchorIndex < size && record.secondAnchorIndex < size &&
+                hints.classCount > 0 && hints.classCount <= CompiledConfigFormat::MAX_REGION_CLASSES;
+
+        for (uint32_t c = 0; valid && c < hints.classCount; ++c) {
+            valid = hints.classes[c] < static_cast<uint8_t>(RegionClass::Count);
+        }
+
+        // The matcher adopts these tables as they are: a zero shift would
+        // stall the Horspool loop, and an anchor on a wildcard byte would
+        // make the anchored kernels miss every match
+        if (valid) {
+            const uint8_t* care = m_file.data() + record.careMask.offset;
+            valid = care[record.anchorIndex] == 0xFF && care[record.secondAnchorIndex] == 0xFF;
+        }
+        for (int b = 0; valid && b < 256; ++b) {
+            valid = record.badCharTable[b] >= 1 && record.badCharTable[b] <= size;
+        }
+    }
+
+    for (uint32_t i = 0; valid && i < head->md5Count; ++i) {
+        valid = md5Index()[i].configIndex < head->configCount;
+    }
+
+    if (!valid) {
+        m_lastError = "Compiled config is corrupted";
+        m_file.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool CompiledConfig::isCurrentFor(const QString& sourcePath) const
+{
+    if (!m_file.isOpen() || spanString(header()->compilerVersion) != Constants::APP_VERSION) {
+        return false;
+    }
+
+    FileIdentity identity;
+    if (!FingerprintCache::identify(sourcePath, identity)) {
+        return false;
+    }
+
+    return identity.size == header()->sourceSize && identity.modified == header()->sourceModified &&
+           identity.fileId == spanString(header()->sourceFileId);
+}
+
+VersionConfig CompiledConfig::config(size_t index) const
+{
+    const CompiledConfigRecord& record = records()[index];
+    const uint8_t* values = m_file.data() + record.valueMask.offset;
+    const uint8_t* care = m_file.data() + record.careMask.offset;
+    const size_t size = record.valueMask.size;
+
+    VersionConfig config;
+    config.isPlayingOffset = record.isPlayingOffset;
+    config.timeOffset = record.timeOffset;
+    config.displayName = spanString(record.displayName);
+
+    config.autoplayPattern = BytePattern(values, care, size);
+
+    config.matcher = std::make_shared<const PatternMatcher>(PatternMatcher::Tables{
+        values, care, size, record.anchorIndex, record.secondAnchorIndex, record.badCharTable
+    });
+
+    std::array<AutoplayRules::Action, AutoplayInput::STATE_COUNT> table;
+    for (size_t state = 0; state < table.size(); ++state) {
+        table[state] = {record.rules[state].value, record.rules[state].delayMs};
+    }
+    config.autoplayRules = AutoplayRules(table);
+
+    const CompiledRegionHints& hints = record.regionHints;
+    config.regionHints.classes.clear();
+    for (uint32_t c = 0; c < hints.classCount; ++c) {
+        config.regionHints.classes.push_back(static_cast<RegionClass>(hints.classes[c]));
+    }
+    config.regionHints.minSize = hints.minSize;
+    config.regionHints.maxSize = hints.maxSize;
+
+    for (uint32_t i = 0; i < header()->md5Count; ++i) {
+        if (md5Index()[i].configIndex == index) {
+            QByteArray digest(reinterpret_cast<const char*>(md5Index()[i].digest), sizeof(md5Index()[i].digest));
+            config.md5Hashes.append(QString::fromLatin1(digest.toHex()));
+        }
+    }
+
+    return config;
+}
+
+int CompiledConfig::findByMD5(const QString& md5Hash) const
+{
+    const QByteArray digest = QByteArray::fromHex(md5Hash.toLatin1());
+    if (digest.size() != 16) {
+        return -1;
+    }
+
+    const CompiledMD5Entry* begin = md5Index();
+    const CompiledMD5Entry* end = begin + header()->md5Count;
+    const CompiledMD5Entry* it = std::lower_bound(begin, end, digest, [](const CompiledMD5Entry& entry, const QByteArray& key) {
+        return std::memcmp(entry.digest, key.constData(), sizeof(entry.digest)) < 0;
+    });
+
+    if (it == end || std::memcmp(it->digest, digest.constData(), sizeof(it->digest)) != 0) {
+        return -1;
+    }
+    return static_cast<int>(it->configIndex);
+}
+
+bool CompiledConfig::write(const QString& path, const QString& sourcePath, const QString& appVersion,
+                           const QString& configVersion, const QList<VersionConfig>& configs)
+{
+    FileIdentity identity;
+    if (!FingerprintCache::identify(sourcePath, identity)) {
+        return false;
+    }
+
+    // Later configurations win a shared hash, as they do in ConfigManager
+    QMap<QByteArray, uint32_t> digests;
+    for (qsizetype i = 0; i < configs.size(); ++i) {
+        for (const QString& md5Hash : configs[i].md5Hashes) {
+            QByteArray digest = QByteArray::fromHex(md5Hash.toLatin1());
+            if (digest.size() == 16) {
+                digests[digest] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    CompiledConfigHeader header = {};
+    std::memcpy(header.magic, CompiledConfigFormat::MAGIC, sizeof(header.magic));
+    header.version = CompiledConfigFormat::FORMAT_VERSION;
+    header.configCount = static_cast<uint32_t>(configs.size());
+    header.md5Count = static_cast<uint32_t>(digests.size());
+    header.recordsOffset = sizeof(CompiledConfigHeader);
+    header.md5IndexOffset = header.recordsOffset + uint64_t(header.configCount) * sizeof(CompiledConfigRecord);
+    header.sourceSize = identity.size;
+    header.sourceModified = identity.modified;
+
+    QByteArray data;
+    data.resize(static_cast<qsizetype>(header.md5IndexOffset + uint64_t(header.md5Count) * sizeof(CompiledMD5Entry)));
+    data.fill('\0');
+    Blob blob(data);
+
+    header.sourceFileId = blob.append(identity.fileId.toUtf8());
+    header.compilerVersion = blob.append(QByteArray(Constants::APP_VERSION));
+    header.appVersion = blob.append(appVersion.toUtf8());
+    header.configVersion = blob.append(configVersion.toUtf8());
+
+    for (qsizetype i = 0; i < configs.size(); ++i) {
+        const VersionConfig& config = configs[i];
+        PatternMatcher built(config.autoplayPattern);
+        const PatternMatcher& matcher = config.matcher ? *config.matcher : built;
+
+        CompiledConfigRecord record = {};
+        record.isPlayingOffset = config.isPlayingOffset;
+        record.timeOffset = config.timeOffset;
+        record.displayName = blob.append(config.displayName.toUtf8());
+        record.valueMask = blob.append(matcher.getValueMask(), matcher.getPatternSize());
+        record.careMask = blob.append(matcher.getCareMask(), matcher.getPatternSize());
+        record.anchorIndex = static_cast<uint32_t>(matcher.getAnchorIndex());
+        record.secondAnchorIndex = static_cast<uint32_t>(matcher.getSecondAnchorIndex());
+        for (size_t b = 0; b < 256; ++b) {
+            record.badCharTable[b] = static_cast<uint32_t>(matcher.getBadCharTable()[b]);
+        }
+        for (size_t state = 0; state < CompiledConfigFormat::RULE_STATES; ++state) {
+            record.rules[state].value = config.autoplayRules.getTable()[state].value;
+            record.rules[state].delayMs = config.autoplayRules.getTable()[state].delayMs;
+        }
+        // Classes are unique, so the list always fits
+        const std::vector<RegionClass>& classes = config.regionHints.classes;
+        for (size_t c = 0; c < classes.size() && c < CompiledConfigFormat::MAX_REGION_CLASSES; ++c) {
+            record.regionHints.classes[record.regionHints.classCount++] = static_cast<uint8_t>(classes[c]);
+        }
+        record.regionHints.minSize = config.regionHints.minSize;
+        record.regionHints.maxSize = config.regionHints.maxSize;
+
+        std::memcpy(data.data() + header.recordsOffset + i * sizeof(CompiledConfigRecord), &record, sizeof(record));
+    }
+
+    size_t entry = 0;
+    for (auto it = digests.begin(); it != digests.end(); ++it, ++entry) {
+        CompiledMD5Entry indexEntry = {};
+        std::memcpy(indexEntry.digest, it.key().constData(), sizeof(indexEntry.digest));
+        indexEntry.configIndex = it.value();
+        std::memcpy(data.data() + header.md5IndexOffset + entry * sizeof(CompiledMD5Entry), &indexEntry, sizeof(indexEntry));
+    }
+
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[ERROR] Could not write compiled config";
+        return false;
+    }
+
+    file.write(data);
+    return file.commit();
+}
+
+const CompiledConfigRecord* CompiledConfig::records() const
+{
+    return reinterpret_cast<const CompiledConfigRecord*>(m_file.data() + header()->recordsOffset);
+}
+
+const CompiledMD5Entry* CompiledConfig::md5Index() const
+{
+    return reinterpret_cast<const CompiledMD5Entry*>(m_file.data() + header()->md5IndexOffset);
+}
+
+bool CompiledConfig::spanValid(const CompiledSpan& span) const
+{
+    return uint64_t(span.offset) + span.size <= m_file.size();
+}
+
+QString CompiledConfig::spanString(const CompiledSpan& span) const
+{
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_file.data() + span.offset), static_cast<qsizetype>(span.size));
+}
@@ -0,0 +1,142 @@
+#ifndef COMPILEDCONFIG_H
+#define COMPILEDCONFIG_H
+
+// Qt includes
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+
+// Project includes
+#include "fingerprintcache.h"
+#include "mappedfile.h"
+
+struct VersionConfig;
+
+// On-disk layout of the compiled config (config.bbacfg). It holds
+// config.json already turned into what the scanner consumes, so a start
+// with an unchanged config.json maps the file and reads it in place. All
+// fields are little-endian and every offset is absolute from the start of
+// the file.
+//
+//   CompiledConfigHeader
+//   CompiledConfigRecord[configCount]
+//   CompiledMD5Entry[md5Count], sorted by digest
+//   strings and pattern masks
+namespace CompiledConfigFormat {
+    constexpr char MAGIC[8] = {'B', 'B', 'A', 'C', 'F', 'G', '\0', '\0'};
+    constexpr uint32_t FORMAT_VERSION = 2;
+    constexpr size_t RULE_STATES = 32;
+    constexpr size_t MAX_REGION_CLASSES = 8;
+}
+
+#pragma pack(push, 1)
+
+struct CompiledSpan {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct CompiledConfigHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t configCount;
+    uint32_t md5Count;
+    uint32_t reserved;
+    uint64_t recordsOffset;
+    uint64_t md5IndexOffset;
+    // Identity of the config.json this was compiled from
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    CompiledSpan sourceFileId;
+    // Build that compiled it; anchor choices may differ between builds
+    CompiledSpan compilerVersion;
+    CompiledSpan appVersion;
+    CompiledSpan configVersion;
+};
+
+struct CompiledRule {
+    int8_t value;
+    uint8_t reserved[3];
+    uint32_t delayMs;
+};
+
+struct CompiledRegionHints {
+    uint8_t classes[CompiledConfigFormat::MAX_REGION_CLASSES];
+    uint32_t classCount;
+    uint32_t reserved;
+    uint64_t minSize;
+    uint64_t maxSize;
+};
+
+struct CompiledConfigRecord {
+    int32_t isPlayingOffset;
+    int32_t timeOffset;
+    CompiledSpan displayName;
+    CompiledSpan valueMask;
+    CompiledSpan careMask;
+    uint32_t anchorIndex;
+    uint32_t secondAnchorIndex;
+    uint32_t badCharTable[256];
+    CompiledRule rules[CompiledConfigFormat::RULE_STATES];
+    CompiledRegionHints regionHints;
+};
+
+struct CompiledMD5Entry {
+    uint8_t digest[16];
+    uint32_t configIndex;
+    uint32_t reserved;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(CompiledConfigHeader) == 88, "CompiledConfigHeader layout changed");
+static_assert(sizeof(CompiledRegionHints) == 32, "CompiledRegionHints layout changed");
+static_assert(sizeof(CompiledConfigRecord) == 1352, "CompiledConfigRecord layout changed");
+static_assert(sizeof(CompiledMD5Entry) == 24, "CompiledMD5Entry layout changed");
+
+// Read-only view of a compiled config. Everything is bounds-checked once in
+// open(); the accessors then read the mapping directly
+class CompiledConfig
+{
+public:
+    // Fails when the file is missing, malformed or from another format
+    bool open(const QString& path);
+
+    // True when the file was compiled by this build from config.json as it
+    // is on disk now
+    bool isCurrentFor(const QString& sourcePath) const;
+
+    QString appVersion() const { return spanString(header()->appVersion); }
+    QString configVersion() const { return spanString(header()->configVersion); }
+    size_t configCount() const { return header()->configCount; }
+
+    // Builds the in-memory config, including the prebuilt matcher, without
+    // deriving anything
+    VersionConfig config(size_t index) const;
+
+    // Index into the configurations for an MD5 hex digest, or -1
+    int findByMD5(const QString& md5Hash) const;
+
+    QString getLastError() const { return m_lastError; }
+
+    // Compiles configs, which came from the config.json at sourcePath, into
+    // path. Written to a temporary file and renamed into place
+    static bool write(const QString& path, const QString& sourcePath, const QString& appVersion,
+                      const QString& configVersion, const QList<VersionConfig>& configs);
+
+private:
+    const CompiledConfigHeader* header() const { return reinterpret_cast<const CompiledConfigHeader*>(m_file.data()); }
+    const CompiledConfigRecord* records() const;
+    const CompiledMD5Entry* md5Index() const;
+    bool spanValid(const CompiledSpan& span) const;
+    QString spanString(const CompiledSpan& span) const;
+
+    MappedFile m_file;
+    QString m_lastError;
+};
+
+#endif // COMPILEDCONFIG_H
@@ -1,10 +1,21 @@
 #include "configmanager.h"
 
+// Project includes
+#include "../core/builtinsignatures.h"
+
 bool ConfigManager::loadFromFile(const QString& configPath)
 {
     m_versionConfigs.clear();
+    m_configurations.clear();
+    m_appVersion.clear();
+    m_configVersion.clear();
     m_lastError.clear();
 
+    if (loadCompiled(configPath)) {
+        qDebug() << "[LOG] Loaded" << m_configurations.size() << "configurations from compiled config";
+        return true;
+    }
+
     QFile file(configPath);
     if (!file.open(QIODevice::ReadOnly)) {
         m_lastError = "Couldn't open config";
@@ -23,6 +34,9 @@ bool ConfigManager::loadFromFile(const QString& configPath)
     }
 
     QJsonObject rootObj = doc.object();
+    m_appVersion = rootObj["app_version"].toString();
+    m_configVersion = rootObj["config_version"].toString();
+
     if (rootObj.contains("configurations")) {
         QJsonArray configurationsArray = rootObj["configurations"].toArray();
         for (const QJsonValue& configValue : configurationsArray) {
@@ -48,10 +62,9 @@ bool ConfigManager::loadFromFile(const QString& configPath)
                 qDebug() << "[WARNING] Autoplay pattern missing for configuration";
                 continue;
             }
-            QJsonArray autoplayArray = configObj["autoplay"].toArray();
-            config.autoplayPattern = parseAutoplay(autoplayArray);
-            if (config.autoplayPattern.empty()) {
-                qDebug() << "[WARNING] Invalid autoplay pattern for configuration";
+            QString patternError;
+            if (!parseAutoplay(configObj["autoplay"], config.autoplayPattern, patternError)) {
+                qDebug() << "[WARNING] Invalid autoplay pattern for configuration:" << patternError;
                 continue;
             }
 
@@ -62,14 +75,27 @@ bool ConfigManager::loadFromFile(const QString& configPath)
             config.isPlayingOffset = configObj["is_playing_offset"].toInt();
             config.timeOffset = configObj["time_offset"].toInt();
 
+            std::vector<AutoplayRule> rules = AutoplayRules::defaultRules();
+            if (configObj.contains("autoplay_rules") &&
+                !parseAutoplayRules(configObj["autoplay_rules"].toArray(), rules)) {
+                qDebug() << "[WARNING] Invalid autoplay rules for configuration:" << config.displayName;
+                continue;
+            }
+            config.autoplayRules = AutoplayRules::compile(rules);
+
+            if (configObj.contains("region_hints") &&
+                !parseRegionHints(configObj["region_hints"].toObject(), config.regionHints)) {
+                qDebug() << "[WARNING] Invalid region hints for configuration:" << config.displayName;
+                continue;
+            }
+
             if (!validateConfig(config)) {
                 qDebug() << "[WARNING] Configuration failed validation:" << config.displayName;
                 continue;
             }
 
-            for (const QString& version : config.md5Hashes) {
-                m_versionConfigs[version] = config;
-            }
+            config.matcher = std::make_shared<const PatternMatcher>(config.autoplayPattern);
+            addConfiguration(config);
         }
     }
 
@@ -78,9 +104,60 @@ bool ConfigManager::loadFromFile(const QString& configPath)
         return false;
     }
 
+    if (!CompiledConfig::write(compiledPathFor(configPath), configPath, m_appVersion, m_configVersion, m_configurations)) {
+        qDebug() << "[WARNING] Failed to write compiled config";
+    }
+
+    return true;
+}
+
+QString ConfigManager::compiledPathFor(const QString& configPath)
+{
+    return QFileInfo(configPath).dir().filePath(Constants::COMPILED_CONFIG_FILENAME);
+}
+
+bool ConfigManager::loadCompiled(const QString& configPath)
+{
+    const QString compiledPath = compiledPathFor(configPath);
+    if (!QFile::exists(compiledPath)) {
+        return false;
+    }
+
+    CompiledConfig compiled;
+    if (!compiled.open(compiledPath)) {
+        qDebug() << "[LOG] Ignoring compiled config:" << compiled.getLastError();
+        return false;
+    }
+    if (!compiled.isCurrentFor(configPath) || compiled.configCount() == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < compiled.configCount(); ++i) {
+        addConfiguration(compiled.config(i));
+    }
+    m_appVersion = compiled.appVersion();
+    m_configVersion = compiled.configVersion();
     return true;
 }
 
+void ConfigManager::addConfiguration(const VersionConfig& config)
+{
+    VersionConfig entry = config;
+
+    // Signatures this build shipped with get the compare generated for them
+    PatternMatcher::Compare compare = BuiltinSignatures::find(entry.autoplayPattern);
+    if (compare && entry.matcher) {
+        auto matcher = std::make_shared<PatternMatcher>(*entry.matcher);
+        matcher->setCompare(compare);
+        entry.matcher = matcher;
+    }
+
+    for (const QString& version : entry.md5Hashes) {
+        m_versionConfigs[version] = entry;
+    }
+    m_configurations.append(entry);
+}
+
 std::optional<VersionConfig> ConfigManager::getVersionConfig(const QString& md5Hash) const
 {
     auto it = m_versionConfigs.find(md5Hash);
@@ -89,29 +166,148 @@ std::optional<VersionConfig> ConfigManager::getVersionConfig(const QString& md5H
     return std::nullopt;
 }
 
-std::vector<int> ConfigManager::parseAutoplay(const QJsonArray& array)
+bool ConfigManager::parseAutoplay(const QJsonValue& value, BytePattern& pattern, QString& error)
 {
-    std::vector<int> pattern;
-    pattern.reserve(array.size());
+    if (value.isString()) {
+        std::string parseError;
+        if (!BytePattern::parse(value.toString().toStdString(), pattern, &parseError)) {
+            error = QString::fromStdString(parseError);
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<int> bytes;
+    const QJsonArray array = value.toArray();
+    bytes.reserve(array.size());
     for (const QJsonValue& v : array) {
         if (v.isDouble()) {
-            int val = v.toInt();
-            pattern.push_back(val);
+            bytes.push_back(v.toInt());
         }
     }
-    return pattern;
+
+    if (bytes.empty() || !BytePattern::fromValues(bytes, pattern)) {
+        error = "Pattern bytes must be -1 or 0..255";
+        return false;
+    }
+    return true;
 }
 
-bool ConfigManager::validateConfig(const VersionConfig& config)
+bool ConfigManager::parseAutoplayRules(const QJsonArray& array, std::vector<AutoplayRule>& rules)
 {
-    if (config.autoplayPattern.empty())
-        return false;
-    
-    for (int byte : config.autoplayPattern) {
-        if (byte != -1 && (byte < 0 || byte > 255))
+    std::vector<AutoplayRule> parsed;
+    parsed.reserve(array.size());
+
+    for (const QJsonValue& ruleValue : array) {
+        QJsonObject ruleObj = ruleValue.toObject();
+        QJsonObject when = ruleObj["when"].toObject();
+        AutoplayRule rule{0, 0, 0, 0};
+
+        auto addLevel = [&rule, &when](const char* key, uint8_t bit) {
+            if (!when.contains(key)) {
+                return true;
+            }
+            if (!when[key].isBool()) {
+                return false;
+            }
+            rule.careMask |= bit;
+            if (when[key].toBool()) {
+                rule.valueMask |= bit;
+            }
+            return true;
+        };
+
+        if (!addLevel("is_playing", AutoplayInput::IS_PLAYING) ||
+            !addLevel("time_positive", AutoplayInput::TIME_POSITIVE)) {
+            return false;
+        }
+
+        if (when.contains("is_playing_edge")) {
+            QString edge = when["is_playing_edge"].toString();
+            uint8_t bit = (edge == "rise") ? AutoplayInput::PLAYING_ROSE
+                        : (edge == "fall") ? AutoplayInput::PLAYING_FELL : 0;
+            if (bit == 0) {
+                return false;
+            }
+            rule.careMask |= bit;
+            rule.valueMask |= bit;
+        }
+
+        if (when.contains("time_edge")) {
+            if (when["time_edge"].toString() != "rise") {
+                return false;
+            }
+            rule.careMask |= AutoplayInput::TIME_ROSE;
+            rule.valueMask |= AutoplayInput::TIME_ROSE;
+        }
+
+        int value = ruleObj["set"].toInt(-1);
+        if (value != 0 && value != 1) {
+            return false;
+        }
+        rule.value = value;
+
+        int delayMs = ruleObj["delay_ms"].toInt(0);
+        if (delayMs < 0 || delayMs > Constants::AUTOPLAY_MAX_RULE_DELAY) {
+            return false;
+        }
+        rule.delayMs = static_cast<uint32_t>(delayMs);
+
+        parsed.push_back(rule);
+    }
+
+    rules = std::move(parsed);
+    return true;
+}
+
+bool ConfigManager::parseRegionHints(const QJsonObject& object, RegionHints& hints)
+{
+    RegionHints parsed;
+
+    if (object.contains("classes")) {
+        parsed.classes.clear();
+        for (const QJsonValue& value : object["classes"].toArray()) {
+            RegionClass regionClass;
+            if (!RegionClassifier::parseClassName(value.toString().toStdString(), regionClass)) {
+                return false;
+            }
+            if (std::find(parsed.classes.begin(), parsed.classes.end(), regionClass) == parsed.classes.end()) {
+                parsed.classes.push_back(regionClass);
+            }
+        }
+        if (parsed.classes.empty()) {
             return false;
+        }
     }
 
+    auto parseSize = [&object](const char* key, uint64_t& size) {
+        if (!object.contains(key)) {
+            return true;
+        }
+        const double value = object[key].toDouble(-1.0);
+        if (value < 0.0 || value != std::floor(value)) {
+            return false;
+        }
+        size = static_cast<uint64_t>(value);
+        return true;
+    };
+
+    if (!parseSize("min_size", parsed.minSize) || !parseSize("max_size", parsed.maxSize) ||
+        (parsed.maxSize != 0 && parsed.maxSize < parsed.minSize)) {
+        return false;
+    }
+
+    hints = std::move(parsed);
+    return true;
+}
+
+bool ConfigManager::validateConfig(const VersionConfig& config)
+{
+    // A pattern of only wildcards matches anywhere and has no byte to
+    // anchor the search on
+    if (config.autoplayPattern.empty() || config.autoplayPattern.fixedCount() == 0)
+        return false;
+
     if (config.isPlayingOffset == 0 || config.timeOffset == 0)
         return false;
 
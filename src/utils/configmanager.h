@@ -6,7 +6,9 @@
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QHash>
+#include <QList>
 #include <QString>
 #include <QStringList>
 #include <QJsonArray>
@@ -14,19 +16,30 @@
 #include <QJsonObject>
 
 // STL includes
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <optional>
 #include <vector>
 
 // Project includes
+#include "../core/autoplayrules.h"
+#include "../core/bytepattern.h"
+#include "../core/patternmatcher.h"
+#include "../core/regionclassifier.h"
+#include "../utils/compiledconfig.h"
 #include "../utils/constants.h"
 
 struct VersionConfig {
-    std::vector<int> autoplayPattern;
+    BytePattern autoplayPattern;
     int isPlayingOffset;
     int timeOffset;
     QString displayName;
     QStringList md5Hashes;
+    AutoplayRules autoplayRules;
+    RegionHints regionHints;
+    // Built once at load, from the pattern or straight from the compiled config
+    std::shared_ptr<const PatternMatcher> matcher;
 
     bool isValid() const {
         return !autoplayPattern.empty() && isPlayingOffset != 0 && timeOffset != 0;
@@ -36,17 +49,49 @@ struct VersionConfig {
 class ConfigManager
 {
 public:
+    // Reads the compiled config next to configPath when it is current,
+    // otherwise parses the JSON and compiles it for the next start
     bool loadFromFile(const QString& configPath);
 
     std::optional<VersionConfig> getVersionConfig(const QString& md5Hash) const;
+    const QList<VersionConfig>& getConfigurations() const { return m_configurations; }
 
+    QString getAppVersion() const { return m_appVersion; }
+    QString getConfigVersion() const { return m_configVersion; }
     QString getLastError() const { return m_lastError; }
 
+    static QString compiledPathFor(const QString& configPath);
+
 private:
-    static std::vector<int> parseAutoplay(const QJsonArray& array);
+    bool loadCompiled(const QString& configPath);
+    void addConfiguration(const VersionConfig& config);
+
+    // "autoplay" is either the original byte array with -1 wildcards or
+    // IDA-style text, e.g. "01 00 00 00 ?? ?? 1C 00"
+    static bool parseAutoplay(const QJsonValue& value, BytePattern& pattern, QString& error);
+
+    // Parses the optional "autoplay_rules" array. Rules are checked in order
+    // and the first whose "when" matches decides the flag, e.g. for a build
+    // that must wait out its count-in:
+    //   [{"when": {"is_playing_edge": "rise"}, "set": 1, "delay_ms": 550},
+    //    {"when": {"is_playing": false}, "set": 0}]
+    // "when" accepts is_playing, time_positive (bools), is_playing_edge
+    // ("rise"/"fall") and time_edge ("rise"). States no rule matches keep
+    // the current value
+    static bool parseAutoplayRules(const QJsonArray& array, std::vector<AutoplayRule>& rules);
+
+    // Parses the optional "region_hints" object, which narrows and orders
+    // the regions scanned for this build, e.g.
+    //   {"classes": ["heap", "image_data"], "min_size": 65536}
+    // "classes" lists RegionClassifier names, most likely first; "min_size"
+    // and "max_size" bound the region size in bytes
+    static bool parseRegionHints(const QJsonObject& object, RegionHints& hints);
     static bool validateConfig(const VersionConfig& config);
 
     QHash<QString, VersionConfig> m_versionConfigs;
+    QList<VersionConfig> m_configurations;
+    QString m_appVersion;
+    QString m_configVersion;
     QString m_lastError;
 };
 
@@ -4,23 +4,56 @@
 #include <cstddef>
 
 namespace Constants {
-    constexpr size_t MEMORY_CHUNK_SIZE = 8 * 1024 * 1024;
+    // Regions are streamed in pieces that stay resident in L2 while searched
+    constexpr size_t MEMORY_CHUNK_SIZE = 1024 * 1024;
+    constexpr size_t SCAN_WORK_ITEM_SIZE = 4 * 1024 * 1024;
+    // Chunk buffers each scan worker keeps in flight; below 2 reads and
+    // searches take turns
+    constexpr size_t SCAN_PIPELINE_DEPTH = 3;
+    // Scan buffers of at least a hugepage ask for hugepages (Linux THP) or
+    // large pages (Windows, needs the lock-memory privilege)
+    constexpr bool SCAN_BUFFER_LARGE_PAGES = true;
+    constexpr size_t SCAN_BUFFER_HUGEPAGE_SIZE = 2 * 1024 * 1024;
     constexpr int NUM_SEARCH_THREADS = 4;
+    // Content of a region is compared between scans through this many
+    // sampled spans of this many bytes
+    constexpr size_t REGION_HASH_SAMPLES = 16;
+    constexpr size_t REGION_HASH_SAMPLE_SIZE = 64;
+    // After a miss, new and changed regions are searched every interval
+    // until the flag turns up or the duration runs out, in ms; every few
+    // passes the whole map is searched again in case the samples missed it
+    constexpr int SCAN_WATCH_INTERVAL = 300;
+    constexpr int SCAN_WATCH_DURATION = 120000;
+    constexpr int SCAN_WATCH_FULL_PASS = 20;
+    // Mappings larger than this are classed apart and skipped by default;
+    // they are GPU staging and shared buffers, not game objects
+    constexpr size_t SCAN_LARGE_MAPPING_SIZE = 64 * 1024 * 1024;
+    // Autoplay polling, in ms: fast while a level is starting, the check
+    // interval during play, backing off to the idle interval in menus
+    constexpr int AUTOPLAY_FAST_INTERVAL = 2;
     constexpr int AUTOPLAY_CHECK_INTERVAL = 50;
+    constexpr int AUTOPLAY_IDLE_INTERVAL = 100;
+    // Song time in seconds past which arming autoplay counts as late
+    constexpr double AUTOPLAY_LATE_ARM_TIME = 0.1;
+    // 1 ms slots, so one turn of the rule timer wheel covers about a second
+    constexpr size_t AUTOPLAY_TIMER_SLOTS = 1024;
+    constexpr int AUTOPLAY_MAX_RULE_DELAY = 10000;
 
     constexpr const char* APP_VERSION = "0.6beta";
     constexpr const char* GAME_PROCESS_NAME = "beatbanger.exe";
 
     constexpr const char* CONFIG_FILENAME = "config.json";
+    constexpr const char* COMPILED_CONFIG_FILENAME = "config.bbacfg";
+    constexpr const char* ADDRESS_CACHE_FILENAME = "addresscache.json";
+    constexpr const char* FINGERPRINT_CACHE_FILENAME = "fingerprints.json";
+    constexpr const char* LATENCY_REPORT_FILENAME = "autoplay_latency.json";
+    constexpr int LATENCY_REFRESH_INTERVAL = 1000;
     constexpr const char* GITHUB_CONFIG_URL = "https://raw.githubusercontent.com/AmphibiDev/BeatBangerAuto-Rework/main/config.json";
     constexpr const char* GITHUB_RELEASES_URL = "https://github.com/AmphibiDev/BeatBangerAuto-Rework/releases/latest";
     constexpr int MAX_REASONABLE_OFFSET = 1024 * 1024;
 
     constexpr int NETWORK_REQUEST_TIMEOUT = 10000;
 
-    constexpr int THREAD_QUIT_TIMEOUT = 2000;
-    constexpr int THREAD_TERMINATE_TIMEOUT = 1000;
-
     constexpr int BUTTON_COOLDOWN_MS = 500;
 }
 
@@ -0,0 +1,201 @@
+#include "fingerprintcache.h"
+
+// STL includes
+#include <algorithm>
+
+// System includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Project includes
+#include "mappedfile.h"
+
+namespace {
+
+// Fed to the hasher a piece at a time so pages are faulted in sequentially
+constexpr size_t HASH_CHUNK_SIZE = 1024 * 1024;
+
+} // namespace
+
+bool FingerprintCache::loadFromFile(const QString& cachePath)
+{
+    m_cachePath = cachePath;
+    m_entries.clear();
+    m_hits = 0;
+    m_misses = 0;
+    m_lastError.clear();
+
+    QFile file(cachePath);
+    if (!file.exists()) {
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_lastError = "Couldn't open fingerprint cache";
+        return false;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    if (!doc.isObject()) {
+        m_lastError = "Invalid fingerprint cache format";
+        return false;
+    }
+
+    QJsonObject rootObj = doc.object();
+    if (rootObj["version"].toInt() != CACHE_FORMAT_VERSION) {
+        qDebug() << "[LOG] Discarding fingerprint cache with old format";
+        return true;
+    }
+
+    QJsonObject entries = rootObj["entries"].toObject();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        QJsonObject entryObj = it.value().toObject();
+        bool sizeOk = false;
+        bool modifiedOk = false;
+        Entry entry;
+        entry.identity.size = entryObj["size"].toString().toULongLong(&sizeOk);
+        entry.identity.modified = entryObj["modified"].toString().toLongLong(&modifiedOk);
+        entry.identity.fileId = entryObj["file_id"].toString();
+        entry.md5 = entryObj["md5"].toString();
+        if (!sizeOk || !modifiedOk || entry.md5.size() != 32) {
+            continue;
+        }
+        m_entries[it.key()] = entry;
+    }
+
+    return true;
+}
+
+bool FingerprintCache::save() const
+{
+    if (m_cachePath.isEmpty()) {
+        return false;
+    }
+
+    QJsonObject entries;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        QJsonObject entryObj;
+        entryObj["size"] = QString::number(it.value().identity.size);
+        entryObj["modified"] = QString::number(it.value().identity.modified);
+        entryObj["file_id"] = it.value().identity.fileId;
+        entryObj["md5"] = it.value().md5;
+        entries[it.key()] = entryObj;
+    }
+
+    QJsonObject rootObj;
+    rootObj["version"] = CACHE_FORMAT_VERSION;
+    rootObj["entries"] = entries;
+
+    QSaveFile file(m_cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[ERROR] Could not write fingerprint cache";
+        return false;
+    }
+
+    file.write(QJsonDocument(rootObj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+QString FingerprintCache::fingerprint(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        return QString();
+    }
+
+    FileIdentity identity;
+    const bool identified = identify(filePath, identity);
+
+    if (identified) {
+        auto it = m_entries.find(filePath);
+        if (it != m_entries.end() && it.value().identity == identity) {
+            ++m_hits;
+            return it.value().md5;
+        }
+    }
+
+    ++m_misses;
+    QString md5 = hashFile(filePath);
+
+    // A file that changed while it was hashed must not be cached under the
+    // identity taken before
+    FileIdentity after;
+    if (!md5.isEmpty() && identified && identify(filePath, after) && after == identity) {
+        m_entries[filePath] = {identity, md5};
+        if (!save()) {
+            qDebug() << "[WARNING] Failed to save fingerprint cache";
+        }
+    }
+
+    return md5;
+}
+
+QString FingerprintCache::hashFile(const QString& filePath)
+{
+    MappedFile mapped;
+    if (!mapped.open(filePath.toStdString())) {
+        qDebug() << "[ERROR] Couldn't map" << filePath << ":" << QString::fromStdString(mapped.getLastError());
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (size_t offset = 0; offset < mapped.size(); offset += HASH_CHUNK_SIZE) {
+        const size_t size = std::min(HASH_CHUNK_SIZE, mapped.size() - offset);
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(mapped.data() + offset),
+                                    static_cast<qsizetype>(size)));
+    }
+    return hash.result().toHex();
+}
+
+#ifdef _WIN32
+
+bool FingerprintCache::identify(const QString& filePath, FileIdentity& identity)
+{
+    HANDLE file = CreateFileW(reinterpret_cast<LPCWSTR>(filePath.utf16()), FILE_READ_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool ok = GetFileInformationByHandle(file, &info);
+    CloseHandle(file);
+    if (!ok) {
+        return false;
+    }
+
+    // FILETIME counts 100 ns steps from 1601
+    constexpr int64_t EPOCH_DIFFERENCE = 116444736000000000LL;
+    const int64_t writeTime = (static_cast<int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                              info.ftLastWriteTime.dwLowDateTime;
+
+    identity.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    identity.modified = (writeTime - EPOCH_DIFFERENCE) * 100;
+    identity.fileId = QString("%1:%2")
+        .arg(info.dwVolumeSerialNumber, 8, 16, QChar('0'))
+        .arg((static_cast<quint64>(info.nFileIndexHigh) << 32) | info.nFileIndexLow, 16, 16, QChar('0'));
+    return true;
+}
+
+#else
+
+bool FingerprintCache::identify(const QString& filePath, FileIdentity& identity)
+{
+    struct stat info;
+    if (stat(QFile::encodeName(filePath).constData(), &info) != 0) {
+        return false;
+    }
+
+    identity.size = static_cast<uint64_t>(info.st_size);
+    identity.modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+    identity.fileId = QString("%1:%2")
+        .arg(static_cast<quint64>(info.st_dev), 0, 16)
+        .arg(static_cast<quint64>(info.st_ino), 0, 16);
+    return true;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef FINGERPRINTCACHE_H
+#define FINGERPRINTCACHE_H
+
+// Qt includes
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QString>
+
+// STL includes
+#include <cstdint>
+
+// What identifies one build of a file on disk without reading it. Replacing
+// the executable changes the file ID even when size and mtime are restored
+struct FileIdentity {
+    uint64_t size;
+    int64_t modified; // last write time, ns since the epoch
+    QString fileId;   // volume serial + file index, or device + inode
+
+    bool operator==(const FileIdentity& other) const {
+        return size == other.size && modified == other.modified && fileId == other.fileId;
+    }
+};
+
+// Remembers the MD5 of each executable by path, so a repeat launch of the
+// same build gets its version from one stat call instead of hashing the
+// whole file
+class FingerprintCache
+{
+public:
+    bool loadFromFile(const QString& cachePath);
+    bool save() const;
+
+    // MD5 hex digest of the file, or an empty string when it can't be read.
+    // Hashes through a memory mapping and stores the result on a miss
+    QString fingerprint(const QString& filePath);
+
+    int getHits() const { return m_hits; }
+    int getMisses() const { return m_misses; }
+    QString getLastError() const { return m_lastError; }
+
+    static bool identify(const QString& filePath, FileIdentity& identity);
+    static QString hashFile(const QString& filePath);
+
+private:
+    static constexpr int CACHE_FORMAT_VERSION = 1;
+
+    struct Entry {
+        FileIdentity identity;
+        QString md5;
+    };
+
+    QString m_cachePath;
+    QHash<QString, Entry> m_entries;
+    int m_hits = 0;
+    int m_misses = 0;
+    QString m_lastError;
+};
+
+#endif // FINGERPRINTCACHE_H
@@ -0,0 +1,106 @@
+#include "latencyhistogram.h"
+
+// STL includes
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint64_t>& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+// Values below 128 get a bucket each; above that, bucket index is
+// 64 * shift + (value >> shift), where shift keeps the top 7 bits
+size_t LatencyHistogram::indexOf(uint64_t value)
+{
+    const uint64_t limit = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    if (value > limit) {
+        value = limit;
+    }
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+
+    unsigned highestBit = 63;
+    while (!(value >> highestBit)) {
+        --highestBit;
+    }
+    unsigned shift = highestBit - (SUB_BUCKET_BITS - 1);
+    return static_cast<size_t>(SUB_BUCKET_HALF * shift + (value >> shift));
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKET_HALF - 1);
+    uint64_t top = index % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+    m_buckets[indexOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    uint64_t seen = m_min.load(std::memory_order_relaxed);
+    while (nanoseconds < seen && !m_min.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+    seen = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > seen && !m_max.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::min() const
+{
+    uint64_t value = m_min.load(std::memory_order_relaxed);
+    return (value == UINT64_MAX) ? 0 : value;
+}
+
+double LatencyHistogram::mean() const
+{
+    uint64_t samples = count();
+    return samples ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / samples : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+    // Buckets are summed rather than trusting m_count, which a concurrent
+    // record() may have bumped before its bucket
+    uint64_t total = 0;
+    for (const std::atomic<uint64_t>& bucket : m_buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    percent = (percent < 0.0) ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * total));
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t index = 0; index < BUCKET_COUNT; ++index) {
+        seen += m_buckets[index].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            uint64_t value = highestEquivalent(index);
+            uint64_t highest = max();
+            return (value < highest) ? value : highest;
+        }
+    }
+    return max();
+}
@@ -0,0 +1,49 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+// STL includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free log-linear (HDR style) histogram of nanosecond values. Each
+// power-of-two range is split into 64 linear buckets, so any recorded value
+// is reported within 1/64 (~1.6%) of its true value, from 1 ns up to about
+// 18 minutes. record() is a couple of relaxed atomic adds and never blocks,
+// so the autoplay thread can record while the UI thread reads
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t min() const;
+    uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // Highest value equivalent to the bucket holding the given percentile
+    // (0-100); 0 when empty
+    uint64_t percentile(double percent) const;
+
+private:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKET_HALF * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2);
+
+    static size_t indexOf(uint64_t value);
+    static uint64_t highestEquivalent(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
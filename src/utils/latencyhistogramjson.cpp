@@ -0,0 +1,17 @@
+#include "latencyhistogramjson.h"
+
+QJsonObject histogramToJson(const LatencyHistogram& histogram)
+{
+    auto micros = [](uint64_t nanoseconds) { return nanoseconds / 1000.0; };
+
+    QJsonObject obj;
+    obj["count"] = static_cast<qint64>(histogram.count());
+    obj["min_us"] = micros(histogram.min());
+    obj["mean_us"] = histogram.mean() / 1000.0;
+    obj["p50_us"] = micros(histogram.percentile(50.0));
+    obj["p90_us"] = micros(histogram.percentile(90.0));
+    obj["p99_us"] = micros(histogram.percentile(99.0));
+    obj["p999_us"] = micros(histogram.percentile(99.9));
+    obj["max_us"] = micros(histogram.max());
+    return obj;
+}
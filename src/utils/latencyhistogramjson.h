@@ -0,0 +1,15 @@
+#ifndef LATENCYHISTOGRAMJSON_H
+#define LATENCYHISTOGRAMJSON_H
+
+// Qt includes
+#include <QJsonObject>
+
+// Project includes
+#include "latencyhistogram.h"
+
+// Count, min, mean, percentiles and max in microseconds, as written to the
+// latency report and by bba_cli. Kept apart from LatencyHistogram so
+// bba_core stays free of Qt
+QJsonObject histogramToJson(const LatencyHistogram& histogram);
+
+#endif // LATENCYHISTOGRAMJSON_H
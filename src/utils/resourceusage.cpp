@@ -0,0 +1,51 @@
+#include "resourceusage.h"
+
+// System includes
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+ResourceUsage ResourceUsage::current()
+{
+    ResourceUsage usage;
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        usage.peakRss = counters.PeakWorkingSetSize;
+        usage.currentRss = counters.WorkingSetSize;
+        usage.pageFaults = counters.PageFaultCount;
+    }
+    return usage;
+}
+
+#else
+
+ResourceUsage ResourceUsage::current()
+{
+    ResourceUsage usage;
+    struct rusage self = {};
+    if (getrusage(RUSAGE_SELF, &self) == 0) {
+        // Reported in kilobytes on Linux
+        usage.peakRss = static_cast<uint64_t>(self.ru_maxrss) * 1024;
+        usage.pageFaults = static_cast<uint64_t>(self.ru_minflt) + static_cast<uint64_t>(self.ru_majflt);
+    }
+
+    // Second field of statm is the resident page count
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long long pages = 0;
+        unsigned long long resident = 0;
+        if (std::fscanf(statm, "%llu %llu", &pages, &resident) == 2) {
+            usage.currentRss = resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+        std::fclose(statm);
+    }
+    return usage;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef RESOURCEUSAGE_H
+#define RESOURCEUSAGE_H
+
+// STL includes
+#include <cstdint>
+
+// Memory counters of this process, for showing what a scan costs
+struct ResourceUsage {
+    // Highest resident set so far, in bytes; the OS never lowers it, so a
+    // scan only shows up when it sets a new peak
+    uint64_t peakRss = 0;
+    uint64_t currentRss = 0;
+    // Since the process started, minor and major together
+    uint64_t pageFaults = 0;
+
+    static ResourceUsage current();
+};
+
+#endif // RESOURCEUSAGE_H
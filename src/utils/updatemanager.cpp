@@ -121,6 +121,15 @@ void UpdateManager::onConfigDownloadFinished()
     }
 }
 
+// The compiled config carries the same header fields as the JSON, so a
+// current one answers version and validity checks without parsing
+bool UpdateManager::openCompiledConfig(CompiledConfig& compiled) const
+{
+    const QString compiledPath = ConfigManager::compiledPathFor(m_localConfigPath);
+    return QFile::exists(compiledPath) && compiled.open(compiledPath) && compiled.isCurrentFor(m_localConfigPath) &&
+           !compiled.appVersion().isEmpty() && !compiled.configVersion().isEmpty() && compiled.configCount() > 0;
+}
+
 QString UpdateManager::readLocalVersion()
 {
     if (!localConfigExists()) {
@@ -128,6 +137,11 @@ QString UpdateManager::readLocalVersion()
         return "0";
     }
 
+    CompiledConfig compiled;
+    if (openCompiledConfig(compiled)) {
+        return compiled.configVersion();
+    }
+
     QFile file(m_localConfigPath);
     if (!file.open(QIODevice::ReadOnly)) {
         qDebug() << "[LOG] Cannot open local config file";
@@ -174,6 +188,11 @@ bool UpdateManager::isLocalConfigValid()
         return false;
     }
 
+    CompiledConfig compiled;
+    if (openCompiledConfig(compiled)) {
+        return true;
+    }
+
     QFile file(m_localConfigPath);
     if (!file.open(QIODevice::ReadOnly)) {
         qDebug() << "[LOG] Cannot open local config file for validation";
@@ -20,6 +20,8 @@
 #include <QDebug>
 
 // Project includes
+#include "../utils/compiledconfig.h"
+#include "../utils/configmanager.h"
 #include "../utils/constants.h"
 
 class UpdateManager : public QObject
@@ -52,6 +54,7 @@ private:
     QString m_currentVersion;
     bool m_updateDialogShown;
 
+    bool openCompiledConfig(CompiledConfig& compiled) const;
     QString readLocalVersion();
     bool saveConfig(const QByteArray& data);
     bool isLocalConfigValid();